@@ -2,7 +2,9 @@
 #include "qhull_ra.h"
 #include "delaunay.h"
 #include "utils.h"
+#include "trace.h"
 #include <math.h> /* to use NAN */
+#include <string.h> /* to use memset */
 
 // void printfacet(qhT* qh, facetT* facet){
 //   vertexT *vertex, **vertexp;
@@ -15,93 +17,420 @@ unsigned facetOK_(facetT* facet, unsigned degenerate){
   return !facet->upperdelaunay && (degenerate || !facet->degenerate);
 } // && simplicial, && !facet->redundant - pas de simplicial avec Qt
 
+/* progress hook of qhull (qh->progress_fn) */
+boolT buildprogress_(qhT* qh){
+  ProgressT* progress = (ProgressT*) qh->progress_object;
+  progress->nprocessed = zzval_(Zprocessed);
+  progress->nfacets    = qh->facet_id;
+  return progress->cancel != 0;
+}
+
+/* set the phase; returns 1 if the tessellation has been cancelled */
+unsigned setphase_(ProgressT* progress, int phase, unsigned ntiles){
+  if(progress){
+    progress->phase  = phase;
+    progress->ntiles = ntiles;
+    progress->ndone  = 0;
+    return progress->cancel != 0;
+  }
+  return 0;
+}
+
+unsigned cancelled_(ProgressT* progress){
+  return progress && progress->cancel;
+}
+
+/* adds the time elapsed since *t to *field, and resets *t */
+void lap_(double* field, double* t){
+  double now = walltime();
+  *field += now - *t;
+  *t = now;
+}
+
+/* memory allocated by tessellation(), counted in the statistics; the
+   memory allocated by the functions of utils.c is counted with account_ */
+void account_(StatsT* stats, size_t size, unsigned nallocs){
+  stats->bytes     += size;
+  stats->allocs    += nallocs;
+  stats->totallocs += nallocs;
+  if(stats->bytes > stats->peakbytes){
+    stats->peakbytes = stats->bytes;
+  }
+}
+
+void* malloc_(StatsT* stats, size_t size){
+  account_(stats, size, 1);
+  return malloc(size);
+}
+
+void* calloc_(StatsT* stats, size_t count, size_t size){
+  account_(stats, count * size, 1);
+  return calloc(count, size);
+}
+
+void free_(StatsT* stats, void* p, size_t size){
+  stats->bytes  -= size;
+  stats->allocs -= 1;
+  free(p);
+}
+
+/* statistics of qhull, to be read before qh_freeqhull */
+void qhullstats_(qhT* qh, StatsT* stats){
+  int totlong, curlong, totshort, curshort, maxlong, totbuffer;
+  stats->npartitions = zzval_(Zpartition) + zzval_(Zpartitionall);
+  stats->nvisible    = zval_(Zvisfacettot);
+  stats->nmerges     = zzval_(Ztotmerge);
+  stats->nretries    = zzval_(Zretry);
+  stats->nfacets     = qh->num_facets;
+  stats->nvertices   = qh->num_vertices;
+  stats->joggle      = qh->JOGGLEmax < REALmax/2 ? qh->JOGGLEmax : 0;
+  qh_memtotal(qh, &totlong, &curlong, &totshort, &curshort, &maxlong,
+              &totbuffer);
+  stats->totshort  = totshort;
+  stats->totlong   = totlong;
+  stats->maxlong   = maxlong;
+  stats->totbuffer = totbuffer;
+  /* the short memory buffers are never released before qh_memfreeshort */
+  size_t qhpeak = (size_t) totbuffer + (size_t) maxlong;
+  size_t postpeak = (size_t) totbuffer + (size_t) totlong + stats->peakbytes;
+  stats->peak = qhpeak > postpeak ? qhpeak : postpeak;
+}
+
+/* lifts the n sites given in rows of dim+1 coordinates to the paraboloid,
+   in place: the last coordinate of each row is set to the squared norm of
+   the dim first ones; if atinfinity, the row n is set to the point at
+   infinity of qhull's option Qz (the mean of the sites, above all of them);
+   this is what qh_projectinput does in a new array */
+void liftsites(double* lifted, unsigned dim, unsigned n, unsigned atinfinity){
+  unsigned stride = dim + 1;
+  double maxboloid = 0;
+  for(unsigned v=0; v < n; v++){
+    double* row = lifted + v*stride;
+    double paraboloid = 0;
+    for(unsigned k=0; k < dim; k++){
+      paraboloid += row[k] * row[k];
+    }
+    row[dim] = paraboloid;
+    if(paraboloid > maxboloid){
+      maxboloid = paraboloid;
+    }
+  }
+  if(atinfinity){
+    double* infinity = lifted + n*stride;
+    for(unsigned k=0; k < dim; k++){
+      infinity[k] = 0;
+    }
+    for(unsigned v=0; v < n; v++){
+      for(unsigned k=0; k < dim; k++){
+        infinity[k] += lifted[v*stride + k];
+      }
+    }
+    for(unsigned k=0; k < dim; k++){
+      infinity[k] /= n;
+    }
+    infinity[dim] = maxboloid * 1.1;
+  }
+}
+
+/* same as qh_new_qhull for a Delaunay triangulation, with the progress hook
+   installed after the initialization of the qhull context; if lifted, the
+   sites are lifted in place (liftsites) and qhull works on them instead of
+   a lifted copy, as it does for the input of the qhull program; the short
+   memory of qhull comes from the pool shared by the tessellations (see
+   qh_MEMpool), for the large ones */
+int runqhull_(
+  qhT*       qh,
+  double*    sites,
+  unsigned   dim,
+  unsigned   n,
+  unsigned   lifted,
+  char*      opts,
+  unsigned   nthreads,
+  ProgressT* progress,
+  StatsT*    stats
+)
+{
+  int exitcode;
+  double t = walltime();
+  unsigned depth = TRACE_OPEN(); /* spans to end after a longjmp */
+  if(!qh->qhmem.ferr){
+    qh_meminit(qh, stderr);
+  }else{
+    qh_memcheck(qh);
+  }
+  if(!qh->qhmem.LASTsize){
+    qh->qhmem.POOLbuffers = True; /* before any buffer, see qh_initqhull_mem */
+  }
+  qh_initqhull_start(qh, NULL, NULL, stderr);
+  qh->NUMthreads = nthreads;
+  if(progress){
+    qh->progress_object = progress;
+    qh->progress_fn     = buildprogress_;
+  }
+  exitcode = setjmp(qh->errexit);
+  if(!exitcode){
+    qh->NOerrexit = False;
+    qh_initflags(qh, opts);
+    TRACE_BEGIN("qhull");
+    if(lifted){
+      qh->PROJECTdelaunay = False;
+      liftsites(sites, dim, n, qh->ATinfinity);
+      qh_init_B(qh, sites, n + (qh->ATinfinity ? 1 : 0), dim+1, False);
+    }else{
+      qh->PROJECTdelaunay = True;
+      qh_init_B(qh, sites, n, dim, False);
+    }
+    qh_qhull(qh);
+    TRACE_END("qhull");
+    lap_(&stats->tbuild, &t);
+    TRACE_BEGIN("qhull output");
+    qh_check_output(qh);
+    qh_prepare_output(qh);
+    if(qh->VERIFYoutput && !qh->STOPpoint && !qh->STOPcone){
+      qh_check_points(qh);
+    }
+    TRACE_END("qhull output");
+    lap_(&stats->ttriangulate, &t);
+  }else{
+    /* qh_errexit or qh_errcancel left "qhull" and the spans of qhull open */
+    TRACE_UNWIND(depth);
+  }
+  qh->NOerrexit = True;
+  return exitcode;
+}
+
+/* frees the arrays of the tiles */
+void freetiles_(TileT* tiles, unsigned ntiles){
+  for(unsigned i=0; i < ntiles; i++){
+    free(tiles[i].simplex.sitesids);
+    free(tiles[i].simplex.center);
+    free(tiles[i].neighbors);
+    free(tiles[i].ridgesids);
+  }
+  free(tiles);
+}
+
+/* frees the circumspheres of the families */
+void freefamilies_(FamilyT* families, unsigned nfamilies){
+  for(unsigned f=0; f < nfamilies; f++){
+    free(families[f].center);
+  }
+  free(families);
+}
+
+/* circumcenter of a qhull facet, allocated with malloc_ */
+double* facetcenter_(qhT* qh, facetT* facet, unsigned dim, StatsT* stats){
+  double* center = malloc_(stats, dim * sizeof(double));
+  double* qhcenter = qh_facetcenter(qh, facet->vertices);
+  for(unsigned i=0; i < dim; i++){
+    center[i] = qhcenter[i];
+  }
+  qh_memfree(qh, qhcenter, qh->center_size);
+  return center;
+}
+
+/* circumcenter of a tile, the one of its family if it has one */
+double* tilecenter_(TileT* tile, FamilyT* families){
+  return tile->family == -1 ? tile->simplex.center
+                            : families[tile->family].center;
+}
+
+/* frees what has been built when the tessellation is cancelled; the arrays
+   are zero-initialized so that the pointers not allocated yet are NULL */
+void freecancelled_(
+  TileT*         tiles,
+  unsigned       ntiles,
+  FamilyT*       families,
+  unsigned       nfamilies,
+  SiteT*         sites,
+  unsigned       n,
+  SubTileT*      ridges,
+  unsigned       nridges
+)
+{
+  freetiles_(tiles, ntiles);
+  freefamilies_(families, nfamilies);
+  if(sites){
+    for(unsigned v=0; v < n; v++){
+      free(sites[v].neighsites);
+      free(sites[v].neighridgesids);
+      free(sites[v].neightiles);
+    }
+    free(sites);
+  }
+  if(ridges){
+    for(unsigned r=0; r < nridges; r++){
+      free(ridges[r].simplex.sitesids);
+      free(ridges[r].simplex.center);
+      free(ridges[r].normal);
+    }
+    free(ridges);
+  }
+}
+
 
 
+/* Delaunay tessellation of the n sites of dimension dim; the qhull context
+   lives on the stack of the call and nothing is shared between calls, so
+   this function can run concurrently on several threads; options, if not
+   NULL, are the qhull options following "qhull d" (then atinfinity is
+   ignored), otherwise they are "Qt Qbb", with "Qz" if atinfinity and "Qx"
+   if dim>3; with the option QJ the input is joggled, all the tiles are
+   simplicial and not degenerate, and the center of each tile is computed
+   from its own vertices; if lifted, the sites are given in rows of dim+1
+   coordinates whose last one is free, with one more row if the point at
+   infinity is added, and qhull works on them without copying them (the
+   caller keeps the ownership of the buffer, which is modified); nthreads
+   threads share the re-partition of the sites of the facets replaced by a
+   new site after merges, with the same result as with one thread; progress,
+   if not NULL, reports the progress and allows to cancel */
 TessellationT* tessellation(
-	double*   sites,
-	unsigned  dim,
-	unsigned  n,
-  unsigned  atinfinity,
-  unsigned  degenerate,
-  double    vthreshold,
-	unsigned* exitcode
+	double*    sites,
+	unsigned   dim,
+	unsigned   n,
+  unsigned   lifted,
+  unsigned   atinfinity,
+  unsigned   degenerate,
+  double     vthreshold,
+  char*      options,
+  unsigned   nthreads,
+  ProgressT* progress,
+  StatsT*    stats,
+	unsigned*  exitcode
 )
 {
-	char opts[50]; /* option flags for qhull, see qh_opt.htm */
-  sprintf(opts, "qhull d Qt Qbb%s%s",
-          atinfinity ? " Qz" : "", dim>3 ? " Qx" : "");
+  StatsT nostats;
+  if(!stats){
+    stats = &nostats;
+  }
+  memset(stats, 0, sizeof(StatsT));
+  double tstart = walltime();
+  unsigned stride = lifted ? dim+1 : dim; /* stride of the sites */
+  TRACE_BEGIN("tessellation");
+  unsigned depth = TRACE_OPEN(); /* spans to end after a cancellation */
+	char opts[250]; /* option flags for qhull, see qh_opt.htm */
+  if(options){
+    snprintf(opts, sizeof(opts), "qhull d %s", options);
+  }else{
+    sprintf(opts, "qhull d Qt Qbb%s%s",
+            atinfinity ? " Qz" : "", dim>3 ? " Qx" : "");
+  }
 	qhT qh_qh; /* Qhull's data structure */
   qhT *qh= &qh_qh;
   QHULL_LIB_CHECK
   qh_meminit(qh, stderr);
-	boolT ismalloc  = False; /* True if qhull should free points in qh_freeqhull() or reallocation */
 	FILE *errfile   = NULL;
-  FILE* outfile   = NULL;
   qh_zero(qh, errfile);
-	*exitcode = qh_new_qhull(qh, dim, n, sites, ismalloc, opts, outfile, errfile);
+  if(progress){
+    progress->npoints = n;
+  }
+  setphase_(progress, PHASE_BUILD, 0);
+	*exitcode = runqhull_(qh, sites, dim, n, lifted, opts, nthreads, progress,
+                        stats);
   //fclose(tmpstdout);
   //printf("exitcode: %u\n", *exitcode);
 
-  TessellationT* out = malloc(sizeof(TessellationT)); /* output */
+  TessellationT* out = malloc_(stats, sizeof(TessellationT)); /* output */
 
 	if (!(*exitcode)) { /* 0 if no error from qhull */
 
-    /* Count the number of facets we keep */
+    /* Count the number of facets we keep, and the families: a tricoplanar
+       facet owning the center of its family is its own triowner */
 		unsigned nfacets = 0; /* to store the number of facets */
+    unsigned nfamilies = 0;
     {
       facetT *facet;  /* set by FORALLfacets */
   		FORALLfacets {
   			if(facetOK_(facet, degenerate)){
           facet->id = nfacets;
   	      nfacets++;
+          if(facet->tricoplanar && facet->f.triowner == facet){
+            nfamilies++;
+          }
         }else{
   				qh_removefacet(qh, facet);
   			}
   		}
     }
 
-    /* Initialize the tiles */
-    TileT* allfacets = malloc(nfacets * sizeof(TileT));
-
-    { /* tiles families and volumes, and centers of tiles with >0 volume */
+    /* with QJ there is no tricoplanar facet: no family to resolve */
+    boolT joggled = qh->JOGGLEmax < REALmax/2;
+
+    /* Initialize the tiles and the families */
+    TileT* allfacets = calloc_(stats, nfacets, sizeof(TileT));
+    FamilyT* families = calloc_(stats, nfamilies, sizeof(FamilyT));
+    setphase_(progress, PHASE_TILES, nfacets);
+    double tlap = walltime();
+    TRACE_BEGIN("tiles");
+
+    { /* families, volumes and centers of the tiles; the circumsphere of a
+         family is computed once, from its tile of largest volume (the
+         owner given by qhull can be flat), and the other tiles have a
+         center if their volume is above the threshold */
+      int* familyof = malloc_(stats, nfacets * sizeof(int));
+      facetT** owners = malloc_(stats, nfamilies * sizeof(facetT*));
       facetT* facet;
+      unsigned i_family = 0;
+      FORALLfacets{
+        familyof[facet->id] = -1;
+        if(facet->tricoplanar && facet->f.triowner == facet){
+          familyof[facet->id] = i_family;
+          families[i_family].owner = facet->id;
+          owners[i_family] = facet;
+          i_family++;
+        }
+      }
       unsigned i_facet = 0;
       FORALLfacets{
+        allfacets[i_facet].family = -1;
         if(facet->tricoplanar){
-          allfacets[i_facet].family = facet->f.triowner->id;
-          // if(!facet->degenerate){
-          //   if(i_facet == 392){
-          //     printf("area: %f", qh_facetarea(qh, facet));
-          //   }
-          //   allfacets[i_facet].simplex.center =
-          //     qh_facetcenter(qh, facet->vertices);
-          // }else{
-          //   facetT *neighbor, **neighborp;
-          //   FOREACHneighbor_(facet){
-          //     if(facetOK_(neighbor,0) && neighbor->f.triowner->id == facet->f.triowner->id){
-          //       allfacets[i_facet].simplex.center =
-          //         qh_facetcenter(qh, neighbor->vertices);
-          //       break;
-          //     }
-          //   }
-          // }
-        }else{
-          allfacets[i_facet].family = -1;
+          /* an owner which is not a tile has no family */
+          unsigned owner = facet->f.triowner->id;
+          if(owner < nfacets){
+            allfacets[i_facet].family = familyof[owner];
+          }
         }
         if(facet->degenerate){ // ?
           allfacets[i_facet].simplex.volume = 0;
         }else{
           allfacets[i_facet].simplex.volume = fmax(0, qh_facetarea(qh, facet));
         }
-        if(allfacets[i_facet].simplex.volume > vthreshold){
-          allfacets[i_facet].simplex.center = malloc(dim * sizeof(double));
-          double* center = qh_facetcenter(qh, facet->vertices);
-          for(unsigned i=0; i < dim; i++){
-            allfacets[i_facet].simplex.center[i] = center[i];
+        int family = allfacets[i_facet].family;
+        if(family != -1){
+          if(allfacets[i_facet].simplex.volume >
+             allfacets[families[family].owner].simplex.volume)
+          {
+            families[family].owner = i_facet;
+            owners[family] = facet;
           }
+        }else if(joggled || allfacets[i_facet].simplex.volume > vthreshold){
+          allfacets[i_facet].simplex.center =
+            facetcenter_(qh, facet, dim, stats);
         }
         i_facet++;
+        if(cancelled_(progress)){
+          break;
+        }
+      }
+      for(unsigned f=0; f < nfamilies && !cancelled_(progress); f++){
+        if(allfacets[families[f].owner].simplex.volume > vthreshold){
+          families[f].center = facetcenter_(qh, owners[f], dim, stats);
+        }else{ /* should not happen */
+          families[f].center = nanvector(dim);
+          account_(stats, dim * sizeof(double), 1);
+        }
+        families[f].radius =
+          sqrt(squaredDistance(((vertexT*)owners[f]->vertices->e[0].p)->point,
+                               families[f].center, dim));
       }
+      free_(stats, owners, nfamilies * sizeof(facetT*));
+      free_(stats, familyof, nfacets * sizeof(int));
+    }
+    if(cancelled_(progress)){
+      freecancelled_(allfacets, nfacets, families, nfamilies, NULL, n,
+                     NULL, 0);
+      *exitcode = qh_ERRcancel;
+      goto cleanup;
     }
 
   	{ /* facets ids, orientations, centers, sites ids, neighbors */
@@ -110,55 +439,25 @@ TessellationT* tessellation(
       FORALLfacets {
         allfacets[i_facet].id             = facet->id;
         allfacets[i_facet].orientation    = facet->toporient ? 1 : -1;
-        /* center and circumradius */
-        if(allfacets[i_facet].simplex.volume <= vthreshold){
-          if(facet->tricoplanar){
-            unsigned ok = 0;
-            vertexT* apex = (vertexT*)facet->vertices->e[0].p;
-            facetT *neighbor, **neighborp;
-            FOREACHneighbor_(apex){
-              if(facetOK_(neighbor,degenerate) &&
-                 allfacets[neighbor->id].family == allfacets[i_facet].family &&
-                 allfacets[neighbor->id].simplex.volume > vthreshold)
-              {
-                allfacets[i_facet].simplex.center =
-                  allfacets[neighbor->id].simplex.center;
-                ok = 1;
-                break;
-              }
-            }
-            if(!ok){ /* should not happen */
-              allfacets[i_facet].simplex.center = nanvector(dim);
-            }
-          }else{ /* should not happen */
+        /* circumradius; the tiles of a family have the one of the family,
+           and the other tiles with volume below the threshold (should not
+           happen) have no center */
+        if(allfacets[i_facet].family != -1){
+          allfacets[i_facet].simplex.radius =
+            families[allfacets[i_facet].family].radius;
+        }else{
+          if(!allfacets[i_facet].simplex.center){
             allfacets[i_facet].simplex.center = nanvector(dim);
+            account_(stats, dim * sizeof(double), 1);
           }
+          allfacets[i_facet].simplex.radius =
+            sqrt(squaredDistance(((vertexT*)facet->vertices->e[0].p)->point,
+                                  allfacets[i_facet].simplex.center, dim));
         }
-//        printf("center facet %u: %f %f %f\n", i_facet, allfacets[i_facet].simplex.center[0], allfacets[i_facet].simplex.center[1], allfacets[i_facet].simplex.center[2]);
-        allfacets[i_facet].simplex.radius =
-          sqrt(squaredDistance(((vertexT*)facet->vertices->e[0].p)->point,
-                                allfacets[i_facet].simplex.center, dim));
-        // allfacets[i_facet].simplex.center =
-        //   facet->degenerate ? nanvector(dim)
-        //                       : qh_facetcenter(qh, facet->vertices);
-        // if(!facet->degenerate){
-        //   allfacets[i_facet].simplex.center = //facet->center;
-        //     qh_facetcenter(qh, facet->vertices);
-        //   // faire une première passe : calculer les centres des triowner
-        //   // pour ne pas les calculer pour les facets de la même famille
-        //   printf("center1: %f %f %f\n", facet->center[0], facet->center[1], facet->center[2]);
-        //   printf("center2: %f %f %f\n", allfacets[i_facet].simplex.center[0], allfacets[i_facet].simplex.center[1], allfacets[i_facet].simplex.center[2]);
-        //   pointT* point = ((vertexT*)facet->vertices->e[0].p)->point;
-        //   allfacets[i_facet].simplex.radius =
-        //     sqrt(squaredDistance(point, allfacets[i_facet].simplex.center,
-        //                          dim));
-        // }// }else{
-        // //   allfacets[i_facet].simplex.radius = NAN;
-        // // }
 
         { /* vertices ids of the facet */
           allfacets[i_facet].simplex.sitesids =
-            malloc((dim+1) * sizeof(unsigned));
+            malloc_(stats, (dim+1) * sizeof(unsigned));
           vertexT *vertex, **vertexp;
           unsigned i_vertex = 0;
           FOREACHvertex_(facet->vertices) {
@@ -181,7 +480,7 @@ TessellationT* tessellation(
             i_neighbor++;
           }
           allfacets[i_facet].neighbors =
-            malloc(allfacets[i_facet].nneighbors * sizeof(unsigned));
+            malloc_(stats, allfacets[i_facet].nneighbors * sizeof(unsigned));
           unsigned countok = 0;
           i_neighbor = 0;
           FOREACHneighbor_(facet) {
@@ -202,25 +501,23 @@ TessellationT* tessellation(
 
         /**/
   			i_facet++;
+        if(progress){
+          progress->ndone = i_facet;
+          if(progress->cancel){
+            break;
+          }
+        }
   		}
     }
-
-    //  /* for degenerate facets, take the center of the owner */
-    // if(degenerate){
-    //   facetT *facet;
-    //   unsigned i_facet = 0;
-    //   FORALLfacets{
-    //     if(facet->degenerate){
-    //       allfacets[i_facet].simplex.center =
-    //         allfacets[allfacets[i_facet].family].simplex.center;
-    //       pointT* point = ((vertexT*)facet->vertices->e[0].p)->point;
-    //       allfacets[i_facet].simplex.radius =
-    //         sqrt(squaredDistance(point, allfacets[i_facet].simplex.center,
-    //                              dim));
-    //     }
-    //     i_facet++;
-    //   }
-    // }
+    lap_(&stats->ttiles, &tlap);
+    TRACE_END("tiles");
+    if(setphase_(progress, PHASE_SITES, nfacets)){
+      freecancelled_(allfacets, nfacets, families, nfamilies, NULL, n,
+                     NULL, 0);
+      *exitcode = qh_ERRcancel;
+      goto cleanup;
+    }
+    TRACE_BEGIN("sites");
 
 		/* neighbor facets and neighbor vertices per vertex */
     /* --- we will use the following combinations, also used later */
@@ -236,27 +533,22 @@ TessellationT* tessellation(
       }
     }
     /* --- initialize the sites */
-    SiteT* allsites = malloc(n * sizeof(SiteT));
-    /* --- array to flag neighbors - 0/1 if not neighbour/neighbour */
-    unsigned** verticesFacetsNeighbours = malloc(n * sizeof(unsigned*));
-		  /* unsigned verticesFacetsNeighbours[n][nfacets] => stackoverflow */
+    SiteT* allsites = calloc_(stats, n, sizeof(SiteT));
     for(unsigned v=0; v < n; v++){
       allsites[v].id           = v;
       allsites[v].nneighsites  = 0;
-      allsites[v].neighsites   = malloc(0); /* will be filled by appending */
+      allsites[v].neighsites   = malloc_(stats, 0); /* filled by appending */
       allsites[v].nneighridges = 0;
       allsites[v].nneightiles  = 0;
-      verticesFacetsNeighbours[v] = uzeros(nfacets);
     }
-    /* --- fill verticesFacetsNeighbours, derive number of neighbor facets */
-    /* --- and derive neighbor sites */
-    for(unsigned i_facet=0; i_facet < nfacets; i_facet++){
+    /* --- count the neighbor facets and derive the neighbor sites; a
+           cancellation stops it, and the next loop does not run then */
+    for(unsigned i_facet=0; i_facet < nfacets && !cancelled_(progress);
+        i_facet++)
+    {
       for(unsigned j=0; j < dim+1; j++){
         unsigned vertexid = allfacets[i_facet].simplex.sitesids[j];
-        if(verticesFacetsNeighbours[vertexid][i_facet] == 0){
-          verticesFacetsNeighbours[vertexid][i_facet] = 1;
-          allsites[vertexid].nneightiles++;
-        }
+        allsites[vertexid].nneightiles++; /* the vertices are distinct */
         for(unsigned k=0; k < dim; k++){
           unsigned vertexid2 =
             allfacets[i_facet].simplex.sitesids[combinations[j][k]];
@@ -265,18 +557,43 @@ TessellationT* tessellation(
                   allsites[vertexid].nneighsites, &pushed);
           if(pushed){
             allsites[vertexid].nneighsites++;
+            account_(stats, sizeof(unsigned), 0);
           }
         }
       }
     }
+    /* --- neighbor facets per vertex, in increasing order */
+    for(unsigned v=0; v < n; v++){
+      allsites[v].neightiles =
+        malloc_(stats, allsites[v].nneightiles * sizeof(unsigned));
+      allsites[v].nneightiles = 0;
+    }
+    for(unsigned i_facet=0; i_facet < nfacets && !cancelled_(progress);
+        i_facet++)
+    {
+      for(unsigned j=0; j < dim+1; j++){
+        SiteT* site = &allsites[allfacets[i_facet].simplex.sitesids[j]];
+        site->neightiles[site->nneightiles++] = i_facet;
+      }
+    }
+
+    lap_(&stats->tsites, &tlap);
+    TRACE_END("sites");
+    if(setphase_(progress, PHASE_RIDGES, nfacets)){
+      freecancelled_(allfacets, nfacets, families, nfamilies, allsites, n,
+                     NULL, 0);
+      *exitcode = qh_ERRcancel;
+      goto cleanup;
+    }
+    TRACE_BEGIN("ridges");
 
     /************************************************************/
     /* second pass on facets: ridges and facet volumes          */
     unsigned n_ridges_dup = nfacets * (dim+1); /* number of ridges with duplicates */
-    SubTileT* allridges_dup = malloc(n_ridges_dup * sizeof(SubTileT));
+    SubTileT* allridges_dup = calloc_(stats, n_ridges_dup, sizeof(SubTileT));
     for(unsigned r=0; r < n_ridges_dup; r++){
-      allridges_dup[r].simplex.sitesids = malloc(dim * sizeof(unsigned));
-      allridges_dup[r].flag = 0;
+      allridges_dup[r].simplex.sitesids =
+        malloc_(stats, dim * sizeof(unsigned));
     }
 //    qh_getarea(qh, qh->facet_list); /* make facets volumes, available in facet->f.area */
     unsigned n_ridges = 0; /* count distinct ridges */
@@ -289,7 +606,8 @@ TessellationT* tessellation(
 
 //        allfacets[i_facet].simplex.volume = facet->f.area;
         allfacets[i_facet].nridges   = dim+1;
-        allfacets[i_facet].ridgesids = malloc((dim+1) * sizeof(unsigned));
+        allfacets[i_facet].ridgesids =
+          malloc_(stats, (dim+1) * sizeof(unsigned));
 
         /* loop on the combinations - it increments i_ridge_dup */
         for(unsigned m=0; m < dim+1; m++){
@@ -360,7 +678,7 @@ TessellationT* tessellation(
 
             pointT* points[dim]; /* the points corresponding to the combination */
             for(unsigned i=0; i < dim; i++){
-              points[i] = getpoint(sites, dim, ids[i]);
+              points[i] = sites + ids[i]*stride;
             }
             double normal[dim]; /* to store the ridge normal */
             if(dim == 2){
@@ -370,17 +688,22 @@ TessellationT* tessellation(
                 sqrt(square(u1)+square(v1));
               allridges_dup[i_ridge_dup].simplex.center =
                 middle(points[0], points[1], dim);
+              account_(stats, dim * sizeof(double), 1);
               allridges_dup[i_ridge_dup].simplex.radius =
-                sqrt(squaredDistance(allridges_dup[i_ridge_dup].simplex.center,
-                                     points[0], dim));
+                sqrt(squaredDistance(points[0],
+                                     allridges_dup[i_ridge_dup].simplex.center,
+                                     dim));
               normal[0] = v1; normal[1] = -u1;
             }else{
               int parity=1;
               double squaredNorm = 0;
+              double rowsdata[(dim-1)*(dim-1)];
+              double* rows[dim-1];
+              for(unsigned j=0; j < dim-1; j++){
+                rows[j] = rowsdata + j*(dim-1);
+              }
               for(unsigned i=0; i < dim; i++){
-                double** rows = malloc((dim-1) * sizeof(double*));
                 for(unsigned j=0; j < dim-1; j++){
-                  rows[j] = (double*) malloc((dim-1) * sizeof(double));
                   for(unsigned k=0; k < dim-1; k++){
                     unsigned kk = k<i ? k : k+1;
                     rows[j][k] = points[j+1][kk] - points[0][kk];
@@ -389,10 +712,6 @@ TessellationT* tessellation(
                 boolT nearzero;
                 normal[i] = parity * qh_determinant(qh, rows, dim-1, &nearzero);
                 squaredNorm += square(normal[i]);
-                for(unsigned j=0; j < dim-1; j++){
-                  free(rows[j]);
-                }
-                free(rows);
                 parity = -parity;
               }
               double surface = sqrt(squaredNorm);
@@ -403,32 +722,32 @@ TessellationT* tessellation(
             }
             qh_normalize2(qh, normal, dim, 1, NULL, NULL);
             allridges_dup[i_ridge_dup].normal =
-              malloc(dim * sizeof(double));
+              malloc_(stats, dim * sizeof(double));
             for(unsigned i=0; i < dim; i++){
               allridges_dup[i_ridge_dup].normal[i] = normal[i];
             }
             allridges_dup[i_ridge_dup].offset =
-              - dotproduct(points[0], normal, dim);
+              - dotproduct(points[0], allridges_dup[i_ridge_dup].normal, dim);
             if(dim > 2){ /* ridge center is already done if dim 2 */
               // if(facet->degenerate){
               //   allridges_dup[i_ridge_dup].simplex.center = nanvector(dim);
               //   allridges_dup[i_ridge_dup].simplex.radius = NAN;
               // }else{
               allridges_dup[i_ridge_dup].simplex.center =
-                malloc(dim * sizeof(double));
+                malloc_(stats, dim * sizeof(double));
+              double* tilecenter = tilecenter_(&allfacets[i_facet], families);
               double scal = 0;
               for(unsigned i=0; i < dim; i++){
-                scal += (points[0][i]-allfacets[i_facet].simplex.center[i]) *
-                          normal[i];
+                scal += (points[0][i]-tilecenter[i]) * normal[i];
               }
               for(unsigned i=0; i < dim; i++){
                 allridges_dup[i_ridge_dup].simplex.center[i] =
-                  allfacets[i_facet].simplex.center[i] + scal*normal[i];
+                  tilecenter[i] + scal*normal[i];
               }
               allridges_dup[i_ridge_dup].simplex.radius =
                 sqrt(squaredDistance(
-                      allridges_dup[i_ridge_dup].simplex.center,
-                      points[0], dim));
+                      points[0],
+                      allridges_dup[i_ridge_dup].simplex.center, dim));
 //              }
             }
             /* orient the normal (used for plotting unbounded Voronoi cells) */
@@ -458,20 +777,29 @@ TessellationT* tessellation(
                 }
               }
             }
-            for(unsigned i=0; i < dim; i++){
-              free(points[i]);
-            }
           }
           i_ridge_dup++;
         } // end loop combinations (m)
         qsortu(allfacets[i_facet].ridgesids, dim+1);
         /**/
         i_facet++;
+        if(progress){
+          progress->ndone = i_facet;
+          if(progress->cancel){
+            break;
+          }
+        }
       } // end FORALLfacets
     }
+    if(cancelled_(progress)){
+      freecancelled_(allfacets, nfacets, families, nfamilies, allsites, n,
+                     allridges_dup, n_ridges_dup);
+      *exitcode = qh_ERRcancel;
+      goto cleanup;
+    }
 
     /* extract unique ridges */
-    SubTileT* allridges = malloc(n_ridges * sizeof(SubTileT));
+    SubTileT* allridges = malloc_(stats, n_ridges * sizeof(SubTileT));
     unsigned inc_ridge = 0;
 		for(unsigned l=0; l < n_ridges_dup; l++){
       if(allridges_dup[l].flag){
@@ -481,10 +809,10 @@ TessellationT* tessellation(
 		}
 
     /* make neighbor ridges per vertex */
-    unsigned* i_ridges_per_vertex = uzeros(n);
+    unsigned* i_ridges_per_vertex = calloc_(stats, n, sizeof(unsigned));
 		for(unsigned v=0; v < n; v++){
       allsites[v].neighridgesids =
-        malloc(allsites[v].nneighridges * sizeof(unsigned));
+        malloc_(stats, allsites[v].nneighridges * sizeof(unsigned));
     }
     for(unsigned l=0; l < n_ridges_dup; l++){
       if(allridges_dup[l].flag){
@@ -497,19 +825,9 @@ TessellationT* tessellation(
       }
     }
 
-    /* order vertices neighbor sites and make neighbor tiles per vertex */
+    /* order vertices neighbor sites */
 		for(unsigned v=0; v < n; v++){
       qsortu(allsites[v].neighsites, allsites[v].nneighsites);
-      allsites[v].neightiles =
-        malloc(allsites[v].nneightiles * sizeof(unsigned));
-			unsigned inc_facet = 0; unsigned inc_vfn = 0;
-			while(inc_vfn < allsites[v].nneightiles){
-				if(verticesFacetsNeighbours[v][inc_facet] == 1){
-          allsites[v].neightiles[inc_vfn] = inc_facet;
-					inc_vfn++;
-				}
-				inc_facet++;
-			}
 		}
 
     /* make the output */
@@ -518,17 +836,37 @@ TessellationT* tessellation(
 	  out->ntiles     = nfacets;
 	  out->subtiles   = allridges;
     out->nsubtiles  = n_ridges;
+    out->families   = families;
+    out->nfamilies  = nfamilies;
+    stats->ntiles   = nfacets;
+    stats->nridges  = n_ridges;
 
-    free(allridges_dup);
-    free(i_ridges_per_vertex);
-    free(verticesFacetsNeighbours);
+    /* the duplicated ridges have been moved to allridges, except their
+       vertices ids when they are not kept */
+		for(unsigned l=0; l < n_ridges_dup; l++){
+      if(!allridges_dup[l].flag){
+        free_(stats, allridges_dup[l].simplex.sitesids, dim * sizeof(unsigned));
+      }
+    }
+    free_(stats, allridges_dup, n_ridges_dup * sizeof(SubTileT));
+    free_(stats, i_ridges_per_vertex, n * sizeof(unsigned));
+    lap_(&stats->tridges, &tlap);
+    TRACE_END("ridges");
+    setphase_(progress, PHASE_DONE, nfacets);
 
 	}
 
 	/* Do cleanup regardless of whether there is an error */
   int curlong, totlong;
+cleanup:
+  TRACE_UNWIND(depth); /* "tiles", "sites" or "ridges" if cancelled */
+  qhullstats_(qh, stats);
+  TRACE_BEGIN("free qhull");
 	qh_freeqhull(qh, !qh_ALL);                /* free long memory */
 	qh_memfreeshort(qh, &curlong, &totlong);  /* free short memory and memory allocator */
+  TRACE_END("free qhull");
+  stats->ttotal = walltime() - tstart;
+  TRACE_END("tessellation");
 
   //printf("RETURN\n");
   if(*exitcode){
@@ -541,11 +879,56 @@ TessellationT* tessellation(
 }
 
 
+/* frees a tessellation returned by tessellation(), n being the number of
+   sites */
+void freeTessellation(TessellationT* tess, unsigned n){
+  for(unsigned v=0; v < n; v++){
+    free(tess->sites[v].neighsites);
+    free(tess->sites[v].neighridgesids);
+    free(tess->sites[v].neightiles);
+  }
+  free(tess->sites);
+  freetiles_(tess->tiles, tess->ntiles);
+  for(unsigned r=0; r < tess->nsubtiles; r++){
+    free(tess->subtiles[r].simplex.sitesids);
+    free(tess->subtiles[r].simplex.center);
+    free(tess->subtiles[r].normal);
+  }
+  free(tess->subtiles);
+  freefamilies_(tess->families, tess->nfamilies);
+  free(tess);
+}
+
+/* predicted peak memory in bytes of tessellation() for n sites of dimension
+   dim in general position: the number of tiles is the expected number of
+   Delaunay tiles per site for uniformly distributed sites, the memory of
+   qhull per tile has been measured, and the memory of the output and the
+   temporary arrays is derived from the sizes of the structures */
+size_t estimatememory(unsigned n, unsigned dim){
+  const double tilespersite[7] = {0, 1, 2, 6.77, 31.78, 170.5, 1040};
+  double tps = tilespersite[dim < 6 ? dim : 6];
+  for(unsigned d=7; d <= dim; d++){
+    tps *= 6;
+  }
+  double ntiles  = tps * n;
+  double nridges = ntiles * (dim+1) / 2; /* each ridge is shared */
+  double qhull = ntiles * (230 + 20*dim) + n * (dim+1) * sizeof(double);
+  double tiles = ntiles * (sizeof(TileT) + dim*sizeof(double) +
+                           3*(dim+1)*sizeof(unsigned));
+  double ridgesdup = ntiles * (dim+1) * (sizeof(SubTileT) + dim*sizeof(unsigned));
+  double ridges = nridges * (sizeof(SubTileT) + 2*dim*sizeof(double));
+  double sites = n * (sizeof(SiteT) + sizeof(unsigned)) +
+                 ntiles * (dim+1) * sizeof(unsigned) +  /* neighbor tiles */
+                 nridges * (dim+2) * sizeof(unsigned);  /* ridges, sites */
+  return (size_t) (qhull + tiles + ridgesdup + ridges + sites);
+}
+
 void testdel2(){
   double sites[27] = {0,0,0, 0,0,1, 0,1,0, 0,1,1, 1,0,0, 1,0,1, 1,1,0, 1,1,1, 0.5,0.5,0.5};
   unsigned exitcode;
   unsigned dim = 3;
-  TessellationT* x = tessellation(sites, dim, 9, 0, 0, 0, &exitcode);
+  TessellationT* x = tessellation(sites, dim, 9, 0, 0, 0, 0, NULL, 1, NULL,
+                                  NULL, &exitcode);
   printf("TESTDEL2 - nfacets:%u\n", x->ntiles);
   for(unsigned f=0; f < x->ntiles; f++){
     printf("facet %u - sites:\n", f);
@@ -573,5 +956,5 @@ void testdel2(){
     printf("ridgeOf: %u %d", x->subtiles[r].ridgeOf1, x->subtiles[r].ridgeOf2);
     printf("\n");
   }
-  free(x);
+  freeTessellation(x, 9);
 }
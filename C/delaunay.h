@@ -1,3 +1,8 @@
+#ifndef DELAUNAY_H
+#define DELAUNAY_H
+
+#include <stddef.h> /* to use size_t */
+
 typedef struct Site {
   unsigned   id;
   unsigned*  neighsites;
@@ -27,6 +32,15 @@ typedef struct SubTile {
 
 #define INIT_SUBTILE(X) SubTileT X = {.flag = 0}
 
+/* the tiles of a family share the circumsphere of the family, computed
+   once from the vertices of the tile owning it (qhull's triowner); their
+   simplex.center is NULL */
+typedef struct Family {
+  unsigned owner;
+  double*  center;
+  double   radius;
+} FamilyT;
+
 typedef struct Tile {
   unsigned  id;
   SimplexT  simplex;
@@ -34,17 +48,80 @@ typedef struct Tile {
   unsigned  nneighbors;
   unsigned* ridgesids;
   unsigned  nridges; //  = dim+1
-  int       family;
+  int       family; /* index in the families, -1 if none */
   int       orientation;
 } TileT;
 
+/* phases of a tessellation, reported in ProgressT */
+#define PHASE_START  0 /* not started yet */
+#define PHASE_BUILD  1 /* qhull */
+#define PHASE_TILES  2 /* tiles volumes, centers and neighbors */
+#define PHASE_SITES  3 /* neighbors of the sites */
+#define PHASE_RIDGES 4 /* ridges */
+#define PHASE_DONE   5
+
+/* progress of a tessellation, written by tessellation() and read by another
+   thread; this thread sets cancel to 1 to stop the tessellation, which then
+   returns with the exit code qh_ERRcancel */
+typedef struct Progress {
+  volatile int      cancel;
+  volatile int      phase;
+  volatile unsigned npoints;    /* number of points given to qhull */
+  volatile unsigned nprocessed; /* points processed by qhull */
+  volatile unsigned nfacets;    /* facets created by qhull */
+  volatile unsigned ntiles;     /* number of tiles */
+  volatile unsigned ndone;      /* tiles done in the current phase */
+} ProgressT;
+
+/* statistics of a tessellation, filled by tessellation() if not NULL; the
+   times are wall times in seconds, the counters are qhull's statistics
+   (stat_r.h), the memory of qhull is given by qh_memtotal and the memory
+   allocated by tessellation() itself (the output and the temporary arrays)
+   is counted in bytes; the memory at the end is the memory of the output */
+typedef struct Stats {
+  double   tbuild;       /* qhull: hull construction, with merging */
+  double   ttriangulate; /* qhull: Qt triangulation, output preparation */
+  double   ttiles;       /* PHASE_TILES */
+  double   tsites;       /* PHASE_SITES */
+  double   tridges;      /* PHASE_RIDGES */
+  double   ttotal;
+  unsigned npartitions;  /* distance tests for partitioning (Zpartition) */
+  unsigned nvisible;     /* visible facets deleted (Zvisfacettot) */
+  unsigned nmerges;      /* merged facets (Ztotmerge) */
+  unsigned nretries;     /* retries due to precision problems (Zretry),
+                            e.g. new joggles with QJ */
+  unsigned nfacets;      /* facets of the hull */
+  unsigned nvertices;    /* vertices of the hull */
+  unsigned ntiles;
+  unsigned nridges;
+  int      totshort;     /* short memory of qhull in use at the end */
+  int      totlong;      /* long memory of qhull in use at the end */
+  int      maxlong;      /* peak of the long memory of qhull */
+  int      totbuffer;    /* short memory buffers of qhull, never released */
+  unsigned allocs;       /* allocations of tessellation() alive at the end */
+  unsigned totallocs;    /* allocations of tessellation() */
+  size_t   bytes;        /* memory of tessellation() in use at the end */
+  size_t   peakbytes;    /* peak of the memory of tessellation() */
+  size_t   peak;         /* peak of the memory of qhull and tessellation() */
+  double   joggle;       /* joggle of the input with QJ (qh.JOGGLEmax) */
+} StatsT;
+
 typedef struct Tessellation {
   SiteT*    sites;
   TileT*    tiles;
   unsigned  ntiles;
   SubTileT* subtiles;
   unsigned  nsubtiles;
+  FamilyT*  families;
+  unsigned  nfamilies;
 } TessellationT;
 
-TessellationT* tessellation(double*, unsigned, unsigned, unsigned, unsigned, double, unsigned*);
+TessellationT* tessellation(double*, unsigned, unsigned, unsigned, unsigned,
+                            unsigned, double, char*, unsigned, ProgressT*,
+                            StatsT*, unsigned*);
+void liftsites(double*, unsigned, unsigned, unsigned);
+void freeTessellation(TessellationT*, unsigned);
+size_t estimatememory(unsigned, unsigned);
 void testdel2();
+
+#endif /* DELAUNAY_H */
@@ -15,6 +15,25 @@
 
 #include "qhull_ra.h"
 
+#if qh_SIMDdist && !REALfloat && !defined(__FMA__) && defined(__GNUC__) \
+  && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define qh_SIMDx86 1
+#else
+#define qh_SIMDx86 0
+#endif
+
+#if qh_SIMPLEXplane
+#define qh_SIMPLEXkernel 1
+#if defined(__GNUC__)
+#define qh_KERNELinline __attribute__((always_inline)) __inline__
+#else
+#define qh_KERNELinline
+#endif
+#else
+#define qh_SIMPLEXkernel 0
+#endif
+
 /*-<a                             href="qh-geom_r.htm#TOC"
   >-------------------------------</a><a name="distplane">-</a>
 
@@ -34,7 +53,37 @@
     qh_distplane [geom_r.c], QhullFacet::distance, and QhullHyperplane::distance are copies
 */
 void qh_distplane(qhT *qh, pointT *point, facetT *facet, realT *dist) {
-  coordT *normal= facet->normal, *coordp, randr;
+  realT randr;
+
+  qh_distplane_nostat(qh, point, facet, dist);
+  zinc_(Zdistplane);
+  if (!qh->RANDOMdist && qh->IStracing < 4)
+    return;
+  if (qh->RANDOMdist) {
+    randr= qh_RANDOMint;
+    *dist += (2.0 * randr / qh_RANDOMmax - 1.0) *
+      qh->RANDOMfactor * qh->MAXabs_coord;
+  }
+  if (qh->IStracing >= 4) {
+    qh_fprintf(qh, qh->ferr, 8001, "qh_distplane: ");
+    qh_fprintf(qh, qh->ferr, 8002, qh_REAL_1, *dist);
+    qh_fprintf(qh, qh->ferr, 8003, "from p%d to f%d\n", qh_pointid(qh, point), facet->id);
+  }
+  return;
+} /* distplane */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="distplane_nostat">-</a>
+
+  qh_distplane_nostat(qh, point, facet, dist )
+    return distance from point to facet, as qh_distplane
+
+  notes:
+    does not count Zdistplane, joggle with qh.RANDOMdist, or trace
+    only reads qh.hull_dim and the facet, so it may run in several threads
+*/
+void qh_distplane_nostat(qhT *qh, pointT *point, facetT *facet, realT *dist) {
+  coordT *normal= facet->normal, *coordp;
   int k;
 
   switch (qh->hull_dim){
@@ -66,21 +115,147 @@ void qh_distplane(qhT *qh, pointT *point, facetT *facet, realT *dist) {
       *dist += *coordp++ * *normal++;
     break;
   }
-  zinc_(Zdistplane);
-  if (!qh->RANDOMdist && qh->IStracing < 4)
-    return;
-  if (qh->RANDOMdist) {
-    randr= qh_RANDOMint;
-    *dist += (2.0 * randr / qh_RANDOMmax - 1.0) *
-      qh->RANDOMfactor * qh->MAXabs_coord;
+} /* distplane_nostat */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="distplanes">-</a>
+
+  qh_distplanes(qh, points, numpoints, facet, dists )
+    return distances from points to facet, as qh_distplane_nostat
+
+  returns:
+    dists[i] for each non-NULL points[i] (undefined if NULL)
+
+  notes:
+    does not count Zdistplane, joggle with qh.RANDOMdist, or trace
+    with qh_SIMDdist, uses AVX2 or SSE2 if the processor has it
+    the sums are in the order of qh_distplane_nostat, without fused
+      multiply-add, so the distances are the same
+    only reads qh.hull_dim and the facet, so it may run in several threads
+
+  design:
+    for each block of 4 (AVX2) or 2 (SSE2) points
+      replace NULL points by facet->normal
+      sum the offset and the products, coordinate by coordinate
+    qh_distplane_nostat for the remaining points
+*/
+#if qh_SIMDx86
+__attribute__((target("avx2")))
+static int qh_distplanes_avx2(qhT *qh, pointT **points, int numpoints, facetT *facet, realT *dists) {
+  coordT *normal= facet->normal, *p0, *p1, *p2, *p3;
+  __m256d sum;
+  int i, k, dim= qh->hull_dim;
+
+  for (i=0; i+4 <= numpoints; i += 4) {
+    p0= points[i] ? points[i] : normal;
+    p1= points[i+1] ? points[i+1] : normal;
+    p2= points[i+2] ? points[i+2] : normal;
+    p3= points[i+3] ? points[i+3] : normal;
+    sum= _mm256_set1_pd(facet->offset);
+    for (k=0; k < dim; k++)
+      sum= _mm256_add_pd(sum, _mm256_mul_pd(_mm256_set_pd(p3[k], p2[k], p1[k], p0[k]),
+                                            _mm256_set1_pd(normal[k])));
+    _mm256_storeu_pd(dists+i, sum);
   }
-  if (qh->IStracing >= 4) {
-    qh_fprintf(qh, qh->ferr, 8001, "qh_distplane: ");
-    qh_fprintf(qh, qh->ferr, 8002, qh_REAL_1, *dist);
-    qh_fprintf(qh, qh->ferr, 8003, "from p%d to f%d\n", qh_pointid(qh, point), facet->id);
+  return i;
+} /* distplanes_avx2 */
+
+__attribute__((target("sse2")))
+static int qh_distplanes_sse2(qhT *qh, pointT **points, int numpoints, facetT *facet, realT *dists) {
+  coordT *normal= facet->normal, *p0, *p1;
+  __m128d sum;
+  int i, k, dim= qh->hull_dim;
+
+  for (i=0; i+2 <= numpoints; i += 2) {
+    p0= points[i] ? points[i] : normal;
+    p1= points[i+1] ? points[i+1] : normal;
+    sum= _mm_set1_pd(facet->offset);
+    for (k=0; k < dim; k++)
+      sum= _mm_add_pd(sum, _mm_mul_pd(_mm_set_pd(p1[k], p0[k]), _mm_set1_pd(normal[k])));
+    _mm_storeu_pd(dists+i, sum);
   }
-  return;
-} /* distplane */
+  return i;
+} /* distplanes_sse2 */
+#endif /* qh_SIMDx86 */
+
+void qh_distplanes(qhT *qh, pointT **points, int numpoints, facetT *facet, realT *dists) {
+  int i= 0;
+
+#if qh_SIMDx86
+  if (__builtin_cpu_supports("avx2"))
+    i= qh_distplanes_avx2(qh, points, numpoints, facet, dists);
+  else if (__builtin_cpu_supports("sse2"))
+    i= qh_distplanes_sse2(qh, points, numpoints, facet, dists);
+#endif
+  for (; i < numpoints; i++) {
+    if (points[i])
+      qh_distplane_nostat(qh, points[i], facet, dists+i);
+  }
+} /* distplanes */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="distfacets">-</a>
+
+  qh_distfacets(qh, point, facets, numfacets, dists )
+    return distances from point to facets, as qh_distplane_nostat
+
+  returns:
+    dists[i] for each facets[i]
+
+  notes:
+    as qh_distplanes, with the facets instead of the points in the vectors
+*/
+#if qh_SIMDx86
+__attribute__((target("avx2")))
+static int qh_distfacets_avx2(qhT *qh, pointT *point, facetT **facets, int numfacets, realT *dists) {
+  coordT *n0, *n1, *n2, *n3;
+  __m256d sum;
+  int i, k, dim= qh->hull_dim;
+
+  for (i=0; i+4 <= numfacets; i += 4) {
+    n0= facets[i]->normal;
+    n1= facets[i+1]->normal;
+    n2= facets[i+2]->normal;
+    n3= facets[i+3]->normal;
+    sum= _mm256_set_pd(facets[i+3]->offset, facets[i+2]->offset, facets[i+1]->offset, facets[i]->offset);
+    for (k=0; k < dim; k++)
+      sum= _mm256_add_pd(sum, _mm256_mul_pd(_mm256_set1_pd(point[k]),
+                                            _mm256_set_pd(n3[k], n2[k], n1[k], n0[k])));
+    _mm256_storeu_pd(dists+i, sum);
+  }
+  return i;
+} /* distfacets_avx2 */
+
+__attribute__((target("sse2")))
+static int qh_distfacets_sse2(qhT *qh, pointT *point, facetT **facets, int numfacets, realT *dists) {
+  coordT *n0, *n1;
+  __m128d sum;
+  int i, k, dim= qh->hull_dim;
+
+  for (i=0; i+2 <= numfacets; i += 2) {
+    n0= facets[i]->normal;
+    n1= facets[i+1]->normal;
+    sum= _mm_set_pd(facets[i+1]->offset, facets[i]->offset);
+    for (k=0; k < dim; k++)
+      sum= _mm_add_pd(sum, _mm_mul_pd(_mm_set1_pd(point[k]), _mm_set_pd(n1[k], n0[k])));
+    _mm_storeu_pd(dists+i, sum);
+  }
+  return i;
+} /* distfacets_sse2 */
+#endif /* qh_SIMDx86 */
+
+void qh_distfacets(qhT *qh, pointT *point, facetT **facets, int numfacets, realT *dists) {
+  int i= 0;
+
+#if qh_SIMDx86
+  if (__builtin_cpu_supports("avx2"))
+    i= qh_distfacets_avx2(qh, point, facets, numfacets, dists);
+  else if (__builtin_cpu_supports("sse2"))
+    i= qh_distfacets_sse2(qh, point, facets, numfacets, dists);
+#endif
+  for (; i < numfacets; i++)
+    qh_distplane_nostat(qh, point, facets[i], dists+i);
+} /* distfacets */
 
 
 /*-<a                             href="qh-geom_r.htm#TOC"
@@ -112,6 +287,7 @@ void qh_distplane(qhT *qh, pointT *point, facetT *facet, realT *dist) {
     caller traces result
     Optimized for outside points.   Tried recording a search set for qh_findhorizon.
     Made code more complicated.
+    With 'QE', does not search the horizon, qh_findbestexact tests the facets
 
   when called by qh_partitionvisible():
     indicated by qh_ISnewfacets
@@ -146,7 +322,7 @@ facetT *qh_findbest(qhT *qh, pointT *point, facetT *startfacet,
   int oldtrace= qh->IStracing;
   unsigned int visitid= ++qh->visit_id;
   int numpartnew=0;
-  boolT testhorizon = True; /* needed if precise, e.g., rbox c D6 | qhull Q0 Tv */
+  boolT testhorizon = !qh->EXACTpredicates; /* needed if precise, e.g., rbox c D6 | qhull Q0 Tv */
 
   zinc_(Zfindbest);
   if (qh->IStracing >= 3 || (qh->TRACElevel && qh->TRACEpoint >= 0 && qh->TRACEpoint == qh_pointid(qh, point))) {
@@ -240,6 +416,165 @@ LABELreturn_best:
 }  /* findbest */
 
 
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="findbestexact">-</a>
+
+  qh_findbestexact(qh, point, startfacet, dist, isoutside, numpart )
+    find a facet that point is outside of, with exact predicates ('QE')
+    walks from the best facet to the facet hit by the ray from qh.interior_point
+    through point, then through its neighbors within qh_SEARCHdist of point
+    only walks through new facets if startfacet is new
+
+  returns:
+    a facet with isoutside if point is outside of it (qh_exactoutside)
+    otherwise the best facet by distance
+    dist is the distance to the facet, it may be negative if isoutside
+    numpart is the number of distance tests and exact predicates
+
+  notes:
+    called by qh_partitionpoint instead of qh_findbestnew and qh_findbest
+    a point outside of the visible facets and of the new hull is outside of
+      a new facet, but not always of the best one by distance: the directed
+      search of qh_findbest may stop at a new facet below point
+    dist(point)/-dist(interior_point) is an affine function for each facet and
+      their maximum is reached at the facet hit by the ray; a facet that is not
+      the maximum has a better neighbor, or a coplanar one with a better
+      neighbor, so the walk reaches it
+    a facet that point is outside of is less than DISTround below point; as
+      qh_findbesthorizon, assumes that it is reached from the facet of the ray
+      through facets within qh_SEARCHdist of point
+    a facet with point more than DISTround above it, but not outside of it with
+      exact predicates, is flat, e.g., for duplicate points, and its hyperplane
+      does not guide the walk; the facets are scanned then, as when the walk
+      stops at a facet that is not new
+    uses qh.visit_id and qh.coplanarfacetset, as qh_findbesthorizon
+
+  design:
+    find the best facet by distance with qh_findbestnew or qh_findbest
+    if point is not outside of it with exact predicates
+      walk to a neighbor with a better dist(point)/-dist(interior_point)
+        through the neighbors with the same ratio, until none is better
+      for each facet within qh_SEARCHdist of point, from the last facet
+        test its neighbors with exact predicates if within qh_SEARCHdist
+      if a facet is flat or the walk stopped at a facet that is not new
+        test the new facets, or all the facets, with exact predicates
+*/
+facetT *qh_findbestexact(qhT *qh, pointT *point, facetT *startfacet,
+           realT *dist, boolT *isoutside, int *numpart) {
+  facetT *bestfacet, *rayfacet, *facet, *neighbor, **neighborp, *facetlist;
+  realT searchdist, pointdist, interiordist, ratiodist, bestratio, raydist;
+  boolT isflat, isnew;
+  int i;
+
+  if (qh->findbestnew)
+    bestfacet= qh_findbestnew(qh, point, startfacet, dist, qh->BESToutside, isoutside, numpart);
+  else
+    bestfacet= qh_findbest(qh, point, startfacet, qh->BESToutside, qh_ISnewfacets, !qh_NOupper,
+                          dist, isoutside, numpart);
+  if (bestfacet == qh->facet_tail) {  /* all new facets upperdelaunay, see qh_findbest */
+    bestfacet= startfacet;
+    qh_distplane(qh, point, bestfacet, dist);
+  }
+  (*numpart)++;
+  if ((*isoutside= qh_exactoutside(qh, point, bestfacet)))
+    return bestfacet;
+  searchdist= qh_SEARCHdist; /* macro, qh.max_outside and qh.DISTround */
+  isflat= (*dist > qh->DISTround);
+  isnew= (startfacet->newfacet && qh->newfacet_list && qh->newfacet_list != qh->facet_tail);
+  qh->visit_id++;
+  bestfacet->visitid= qh->visit_id;
+  rayfacet= bestfacet;
+  raydist= *dist;
+  (*numpart)++;
+  qh_distplane(qh, qh->interior_point, rayfacet, &interiordist);
+  bestratio= (interiordist < 0.0 ? raydist / -interiordist : -REALmax);
+  SETfirst_(qh->coplanarfacetset)= rayfacet;
+  SETtruncate_(qh->coplanarfacetset, 1);
+  for (i=0; i < qh_setsize(qh, qh->coplanarfacetset); i++) {
+    facet= SETelemt_(qh->coplanarfacetset, i, facetT);
+    FOREACHneighbor_(facet) {
+      if (neighbor->visitid == qh->visit_id || neighbor->visible || (isnew && !neighbor->newfacet))
+        continue;
+      neighbor->visitid= qh->visit_id;
+      (*numpart)++;
+      qh_distplane(qh, qh->interior_point, neighbor, &interiordist);
+      if (interiordist >= 0.0)
+        continue;
+      (*numpart)++;
+      qh_distplane(qh, point, neighbor, &pointdist);
+      ratiodist= bestratio * -interiordist;  /* pointdist for the same ratio */
+      if (pointdist > ratiodist + qh->DISTround) {
+        bestratio= pointdist / -interiordist;
+        rayfacet= neighbor;
+        raydist= pointdist;
+        SETfirst_(qh->coplanarfacetset)= rayfacet;
+        SETtruncate_(qh->coplanarfacetset, 1);
+        i= -1;
+        break;
+      }else if (pointdist >= ratiodist - qh->DISTround)
+        qh_setappend(qh, &qh->coplanarfacetset, neighbor);  /* coplanar with rayfacet */
+    }
+  }
+  if (rayfacet != bestfacet) {
+    (*numpart)++;
+    if (qh_exactoutside(qh, point, rayfacet)) {
+      *dist= raydist;
+      *isoutside= True;
+      zinc_(Zfindexactwalk);
+      return rayfacet;
+    }
+    isflat |= (raydist > qh->DISTround);
+  }
+  qh->visit_id++;
+  bestfacet->visitid= qh->visit_id;
+  rayfacet->visitid= qh->visit_id;
+  SETfirst_(qh->coplanarfacetset)= rayfacet;
+  SETtruncate_(qh->coplanarfacetset, 1);
+  for (i=0; i < qh_setsize(qh, qh->coplanarfacetset); i++) {
+    facet= SETelemt_(qh->coplanarfacetset, i, facetT);
+    FOREACHneighbor_(facet) {
+      if (neighbor->visitid == qh->visit_id || neighbor->visible || (isnew && !neighbor->newfacet))
+        continue;
+      neighbor->visitid= qh->visit_id;
+      (*numpart)++;
+      qh_distplane(qh, point, neighbor, &pointdist);
+      if (pointdist < -searchdist)
+        continue;
+      (*numpart)++;
+      if (qh_exactoutside(qh, point, neighbor)) {
+        *dist= pointdist;
+        *isoutside= True;
+        zinc_(Zfindexactwalk);
+        trace4((qh, qh->ferr, 4068, "qh_findbestexact: p%d is outside of f%d, not of the best facet f%d\n",
+          qh_pointid(qh, point), neighbor->id, bestfacet->id));
+        return neighbor;
+      }
+      isflat |= (pointdist > qh->DISTround);
+      qh_setappend(qh, &qh->coplanarfacetset, neighbor);
+    }
+  }
+  if (!isflat && (!isnew || rayfacet->newfacet))
+    return bestfacet;
+  zinc_(Zfindexactscan);  /* flat facet with exact predicates, or walk stopped at a horizon facet */
+  if (isnew)
+    facetlist= qh->newfacet_list;
+  else
+    facetlist= qh->facet_list;
+  FORALLfacet_(facetlist) {
+    if (facet == bestfacet || facet->visible)
+      continue;
+    (*numpart)++;
+    if (qh_exactoutside(qh, point, facet)) {
+      qh_distplane(qh, point, facet, dist);
+      *isoutside= True;
+      trace4((qh, qh->ferr, 4069, "qh_findbestexact: p%d is outside of f%d, found by a scan of the facets\n",
+        qh_pointid(qh, point), facet->id));
+      return facet;
+    }
+  }
+  return bestfacet;
+} /* findbestexact */
+
 /*-<a                             href="qh-geom_r.htm#TOC"
   >-------------------------------</a><a name="findbesthorizon">-</a>
 
@@ -388,11 +723,15 @@ facetT *qh_findbesthorizon(qhT *qh, boolT ischeckmax, pointT* point, facetT *sta
     Uses qh.visit_id, qh.coplanarfacetset.
     If share visit_id with qh_findbest, coplanarfacetset is incorrect.
 
+    One qh_distplane per facet.  qh_distfacets in blocks of qh_DISTbatch facets
+    was not faster: the time is in loading the facets of qh.newfacet_list.
+
     If merging (testhorizon), searches horizon facets of coplanar best facets because
     a point maybe coplanar to the bestfacet, below its horizon facet,
     and above a horizon facet of a coplanar newfacet.  For example,
       rbox 1000 s Z1 G1e-13 | qhull
       rbox 1000 s W1e-13 P0 t992110337 | QHULL d Qbb Qc
+    With 'QE', does not search the horizon, qh_findbestexact tests the facets
 
     qh_findbestnew() used if
        qh_sharpnewfacets -- newfacets contains a sharp angle
@@ -417,7 +756,7 @@ facetT *qh_findbestnew(qhT *qh, pointT *point, facetT *startfacet,
   unsigned int visitid= ++qh->visit_id;
   realT distoutside= 0.0;
   boolT isdistoutside; /* True if distoutside is defined */
-  boolT testhorizon = True; /* needed if precise, e.g., rbox c D6 | qhull Q0 Tv */
+  boolT testhorizon = !qh->EXACTpredicates; /* needed if precise, e.g., rbox c D6 | qhull Q0 Tv */
 
   if (!startfacet) {
     if (qh->MERGING)
@@ -465,7 +804,7 @@ facetT *qh_findbestnew(qhT *qh, pointT *point, facetT *startfacet,
       } /* end of !flipped */
     } /* FORALLfacet from startfacet or qh->newfacet_list */
   }
-  if (testhorizon || !bestfacet) /* testhorizon is always True.  Keep the same code as qh_findbest */
+  if (testhorizon || !bestfacet) /* testhorizon is True unless 'QE'.  Keep the same code as qh_findbest */
     bestfacet= qh_findbesthorizon(qh, !qh_IScheckmax, point, bestfacet ? bestfacet : startfacet,
                                         !qh_NOupper, &bestdist, numpart);
   *dist= bestdist;
@@ -915,10 +1254,13 @@ pointT *qh_projectpoint(qhT *qh, pointT *point, facetT *facet, realT dist) {
   notes:
     uses global buffers qh.gm_matrix and qh.gm_row
     overwrites facet->normal if already defined
+    if qh_LEANfacets, a new normal is stored in the facet (qh_INLINEnormal_)
     updates Wnewvertex if PRINTstatistics
     sets facet->upperdelaunay if upper envelope of Delaunay triangulation
 
   design:
+    if 5-d to 7-d and simplicial
+      set hyperplane with qh_sethyperplane_simplex
     copy vertex coordinates to qh.gm_matrix/gm_row
     compute determinate
     if nearzero
@@ -929,17 +1271,24 @@ pointT *qh_projectpoint(qhT *qh, pointT *point, facetT *facet, realT dist) {
 void qh_setfacetplane(qhT *qh, facetT *facet) {
   pointT *point;
   vertexT *vertex, **vertexp;
-  int normsize= qh->normal_size;
   int k,i, oldtrace= 0;
   realT dist;
+#if !qh_LEANfacets
+  int normsize= qh->normal_size;
   void **freelistp; /* used if !qh_NOmem by qh_memalloc_() */
+#endif
   coordT *coord, *gmcoord;
   pointT *point0= SETfirstt_(facet->vertices, vertexT)->point;
-  boolT nearzero= False;
+  boolT nearzero= False, issimplex= False;
 
   zzinc_(Zsetplane);
-  if (!facet->normal)
+  if (!facet->normal) {
+#if qh_LEANfacets
+    facet->normal= qh_INLINEnormal_(qh, facet);
+#else
     qh_memalloc_(qh, normsize, freelistp, facet->normal, coordT);
+#endif
+  }
   if (facet == qh->tracefacet) {
     oldtrace= qh->IStracing;
     qh->IStracing= 5;
@@ -966,8 +1315,9 @@ void qh_setfacetplane(qhT *qh, facetT *facet) {
     }
     qh_sethyperplane_det(qh, qh->hull_dim, qh->gm_row, point0, facet->toporient,
                 facet->normal, &facet->offset, &nearzero);
-  }
-  if (qh->hull_dim > 4 || nearzero) {
+  }else if (facet->simplicial && !qh->RANDOMdist)
+    issimplex= qh_sethyperplane_simplex(qh, facet, point0);  /* 5-d to 7-d */
+  if ((qh->hull_dim > 4 && !issimplex) || nearzero) {
     i= 0;
     gmcoord= qh->gm_matrix;
     FOREACHvertex_(facet->vertices) {
@@ -1015,6 +1365,11 @@ void qh_setfacetplane(qhT *qh, facetT *facet) {
         facet->upperdelaunay= True;
     }
   }
+  if (qh->EXACTpredicates) {
+    qh_exactplane(qh, facet);
+    if (qh->DELAUNAY)
+      facet->upperdelaunay= qh_exactupper(qh, facet);
+  }
   if (qh->PRINTstatistics || qh->IStracing || qh->TRACElevel || qh->JOGGLEmax < REALmax) {
     qh->old_randomdist= qh->RANDOMdist;
     qh->RANDOMdist= False;
@@ -1230,5 +1585,128 @@ void qh_sethyperplane_gauss(qhT *qh, int dim, coordT **rows, pointT *point0,
     *offset -= *pointcoord++ * *normalcoef++;
 } /* sethyperplane_gauss */
 
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="sethyperplane_simplex">-</a>
+
+  qh_sethyperplane_simplex(qh, facet, point0 )
+    set normalized hyperplane equation of a simplicial facet in 5-d to 7-d
+    point0 is a vertex of facet
+
+  returns:
+    True if set facet->normal and facet->offset, as qh_sethyperplane_gauss
+    False if a pivot, a diagonal or the norm is near zero, or if not
+      qh_SIMPLEXplane (facet->normal may be overwritten)
+
+  notes:
+    the rows are in a local array and the loops have a constant length
+      for each dimension (qh_KERNELinline), so that the compiler specializes them
+    same operations as qh_gausselim, qh_backnormal and qh_normalize2,
+      in the same order, for the same hyperplane
+    the caller uses qh_sethyperplane_gauss if False, which counts the
+      near zero pivots and traces them
+    assumes !qh.RANDOMdist
+
+  design:
+    copy the vertices minus point0 to the rows
+    Gaussian elimination with partial pivoting
+    back substitution for the normal
+    normalize the normal and set the offset
+*/
+#if qh_SIMPLEXkernel
+#define qh_SIMPLEXdimmax 7
+
+static qh_KERNELinline boolT qh_sethyperplane_simplexdim(qhT *qh, int dim, facetT *facet, pointT *point0) {
+  realT rows[qh_SIMPLEXdimmax-1][qh_SIMPLEXdimmax];
+  realT n, pivot, pivot_abs= 0.0, temp, norm= 0.0, offset;
+  coordT *normal= facet->normal;
+  vertexT *vertex, **vertexp;
+  boolT sign= facet->toporient;
+  int i, j, k, pivoti;
+
+  i= 0;
+  FOREACHvertex_(facet->vertices) {
+    if (vertex->point != point0) {
+      for (k=0; k < dim; k++)
+        rows[i][k]= vertex->point[k] - point0[k];
+      i++;
+    }
+  }
+  for (k=0; k < dim-1; k++) {
+    pivot_abs= fabs_(rows[k][k]);
+    pivoti= k;
+    for (i=k+1; i < dim-1; i++) {
+      if ((temp= fabs_(rows[i][k])) > pivot_abs) {
+        pivot_abs= temp;
+        pivoti= i;
+      }
+    }
+    if (pivoti != k) {
+      for (j=k; j < dim; j++) {  /* the columns before k are not used */
+        temp= rows[pivoti][j];
+        rows[pivoti][j]= rows[k][j];
+        rows[k][j]= temp;
+      }
+      sign ^= 1;
+    }
+    if (pivot_abs <= qh->NEARzero[k])
+      return False;
+    pivot= rows[k][k];
+    for (i=k+1; i < dim-1; i++) {
+      n= rows[i][k]/pivot;
+      for (j=k+1; j < dim; j++)
+        rows[i][j] -= n * rows[k][j];
+    }
+  }
+  for (k=dim-1; k--; ) {
+    if (rows[k][k] < 0)
+      sign ^= 1;
+  }
+  normal[dim-1]= (sign ? -1.0 : 1.0);
+  for (i=dim-1; i--; ) {
+    temp= 0.0;
+    for (j=i+1; j < dim; j++)
+      temp -= rows[i][j] * normal[j];
+    if (fabs_(rows[i][i]) <= qh->MINdenom_2)
+      return False;
+    normal[i]= temp / rows[i][i];
+  }
+  for (k=0; k < dim; k++)
+    norm += normal[k] * normal[k];
+  norm= sqrt(norm);
+  if (norm <= qh->MINdenom)
+    return False;
+  wmin_(Wmindenom, pivot_abs);  /* as qh_gausselim and qh_normalize2 */
+  wmin_(Wmindenom, norm);
+  for (k=0; k < dim; k++)
+    normal[k] /= norm;
+  offset= -(point0[0] * normal[0]);
+  for (k=1; k < dim; k++)
+    offset -= point0[k] * normal[k];
+  facet->offset= offset;
+  return True;
+} /* sethyperplane_simplexdim */
+#endif /* qh_SIMPLEXkernel */
+
+boolT qh_sethyperplane_simplex(qhT *qh, facetT *facet, pointT *point0) {
+  boolT isset= False;
+
+#if qh_SIMPLEXkernel
+  switch (qh->hull_dim) {
+  case 5:
+    isset= qh_sethyperplane_simplexdim(qh, 5, facet, point0);
+    break;
+  case 6:
+    isset= qh_sethyperplane_simplexdim(qh, 6, facet, point0);
+    break;
+  case 7:
+    isset= qh_sethyperplane_simplexdim(qh, 7, facet, point0);
+    break;
+  }
+  if (isset)
+    zinc_(Zsetplanesimplex);
+#endif
+  return isset;
+} /* sethyperplane_simplex */
+
 
 
@@ -96,6 +96,33 @@
 #define dZ( p1,p2 )  ( *( rows[p1]+2 ) - *( rows[p2]+2 ))
 #define dW( p1,p2 )  ( *( rows[p1]+3 ) - *( rows[p2]+3 ))
 
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >--------------------------------</a><a name="EXACTdim">-</a>
+
+  qh_EXACTdim
+    max. dimension of the hull for exact predicates ('QE', predicates_r.c)
+    the determinants are expanded by subsets of columns
+*/
+#define qh_EXACTdim 9
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >--------------------------------</a><a name="EXACTplane_">-</a>
+
+  qh_EXACTplane_(qh, facet)
+    the cofactors of facet for qh_exactoutside ('QE'), set by qh_exactplane
+    hull_dim+1 doubles in the block of the facet, see qh_newfacet
+*/
+#define qh_EXACTplane_(qh, facet) ((double *)((char *)(facet) + (qh)->exact_offset))
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >--------------------------------</a><a name="EXACTsign_">-</a>
+
+  qh_EXACTsign_(facet)
+    sign of T(p) of qh_exactoutside for the points p above facet
+    as the normal of qh_sethyperplane_det, it is flipped by facet->toporient
+*/
+#define qh_EXACTsign_(facet) ((facet)->toporient ? -1 : 1)
+
 /*============= prototypes in alphabetical order, infrequent at end ======= */
 
 #ifdef __cplusplus
@@ -103,10 +130,18 @@ extern "C" {
 #endif
 
 void    qh_backnormal(qhT *qh, realT **rows, int numrow, int numcol, boolT sign, coordT *normal, boolT *nearzero);
+void    qh_distfacets(qhT *qh, pointT *point, facetT **facets, int numfacets, realT *dists);
 void    qh_distplane(qhT *qh, pointT *point, facetT *facet, realT *dist);
+void    qh_distplane_nostat(qhT *qh, pointT *point, facetT *facet, realT *dist);
+void    qh_distplanes(qhT *qh, pointT **points, int numpoints, facetT *facet, realT *dists);
+boolT   qh_exactoutside(qhT *qh, pointT *point, facetT *facet);
+void    qh_exactplane(qhT *qh, facetT *facet);
+boolT   qh_exactupper(qhT *qh, facetT *facet);
 facetT *qh_findbest(qhT *qh, pointT *point, facetT *startfacet,
                      boolT bestoutside, boolT isnewfacets, boolT noupper,
                      realT *dist, boolT *isoutside, int *numpart);
+facetT *qh_findbestexact(qhT *qh, pointT *point, facetT *startfacet, realT *dist,
+                     boolT *isoutside, int *numpart);
 facetT *qh_findbesthorizon(qhT *qh, boolT ischeckmax, pointT *point,
                      facetT *startfacet, boolT noupper, realT *bestdist, int *numpart);
 facetT *qh_findbestnew(qhT *qh, pointT *point, facetT *startfacet, realT *dist,
@@ -126,6 +161,7 @@ void    qh_sethyperplane_det(qhT *qh, int dim, coordT **rows, coordT *point0,
               boolT toporient, coordT *normal, realT *offset, boolT *nearzero);
 void    qh_sethyperplane_gauss(qhT *qh, int dim, coordT **rows, pointT *point0,
              boolT toporient, coordT *normal, coordT *offset, boolT *nearzero);
+boolT   qh_sethyperplane_simplex(qhT *qh, facetT *facet, pointT *point0);
 boolT   qh_sharpnewfacets(qhT *qh);
 
 /*========= infrequently used code in geom2_r.c =============*/
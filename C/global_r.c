@@ -382,7 +382,7 @@ void qh_freebuild(qhT *qh, boolT allmem) {
       if (facet->next)
         qh_delfacet(qh, facet);
       else {
-        qh_memfree(qh, facet, (int)sizeof(facetT));
+        qh_memfree(qh, facet, qh->facet_size);
         qh->visible_list= qh->newfacet_list= qh->facet_list= NULL;
       }
     }
@@ -398,6 +398,7 @@ void qh_freebuild(qhT *qh, boolT allmem) {
     }
   }
   qh_setfree(qh, &(qh->hash_table));
+  qh_freenewhash(qh);
   qh_memfree(qh, qh->interior_point, qh->normal_size);
   qh->interior_point= NULL;
   FOREACHmerge_(qh->facet_mergeset)  /* usually empty */
@@ -1057,6 +1058,10 @@ void qh_initflags(qhT *qh, char *command) {
           qh_option(qh, "Qcoplanar-keep", NULL, NULL);
           qh->KEEPcoplanar= True;
           break;
+        case 'E':
+          qh_option(qh, "QExact-predicates", NULL, NULL);
+          qh->EXACTpredicates= True;
+          break;
         case 'f':
           qh_option(qh, "Qfurthest-outside", NULL, NULL);
           qh->BESToutside= True;
@@ -1479,6 +1484,13 @@ void qh_initqhull_globals(qhT *qh, coordT *points, int numpoints, int dim, boolT
   qh->first_point= points;
   qh->num_points= numpoints;
   qh->hull_dim= qh->input_dim= dim;
+  if (qh->EXACTpredicates) {
+    if (qh->MERGEexact || qh->PREmerge || qh->POSTmerge || qh->JOGGLEmax < REALmax/2) {
+      qh_fprintf(qh, qh->ferr, 6273, "qhull input error: exact predicates('QE') do not merge facets.  Can not use them with exact merges('Qx'), merge options('Cn' and 'An'), or joggle('QJ')\n");
+      qh_errexit(qh, qh_ERRinput, NULL, NULL);
+    }
+    qh->NOpremerge= True;
+  }
   if (!qh->NOpremerge && !qh->MERGEexact && !qh->PREmerge && qh->JOGGLEmax > REALmax/2) {
     qh->MERGING= True;
     if (qh->hull_dim <= 4) {
@@ -1557,6 +1569,11 @@ void qh_initqhull_globals(qhT *qh, coordT *points, int numpoints, int dim, boolT
     qh_fprintf(qh, qh->ferr, 6050, "qhull error: dimension %d must be > 1\n", qh->hull_dim);
     qh_errexit(qh, qh_ERRinput, NULL, NULL);
   }
+  if (qh->EXACTpredicates && qh->hull_dim > qh_EXACTdim) {
+    qh_fprintf(qh, qh->ferr, 6274, "qhull input error: exact predicates('QE') are for dimension %d or less.  The dimension is %d\n",
+      qh_EXACTdim, qh->hull_dim);
+    qh_errexit(qh, qh_ERRinput, NULL, NULL);
+  }
   for (k=2, factorial=1.0; k < qh->hull_dim; k++)
     factorial *= k;
   qh->AREAfactor= 1.0 / factorial;
@@ -1564,6 +1581,14 @@ void qh_initqhull_globals(qhT *qh, coordT *points, int numpoints, int dim, boolT
         dim, numpoints, ismalloc, qh->PROJECTinput, qh->hull_dim));
   qh->normal_size= qh->hull_dim * sizeof(coordT);
   qh->center_size= qh->normal_size - sizeof(coordT);
+  qh->facet_size= (int)sizeof(facetT) + 2 * SETinlinesize_(qh->hull_dim);
+  if (qh->EXACTpredicates) {
+    qh->exact_offset= qh->facet_size;  /* qh_EXACTplane_ */
+    qh->facet_size += (qh->hull_dim + 1) * (int)sizeof(double);
+  }
+#if qh_LEANfacets
+  qh->facet_size += qh->normal_size;  /* qh_INLINEnormal_ */
+#endif
   pointsneeded= qh->hull_dim+1;
   if (qh->hull_dim > qh_DIMmergeVertex) {
     qh->MERGEvertices= False;
@@ -1652,21 +1677,44 @@ qhull configuration warning (qh_RANDOMmax in user.h):\n\
 
   notes:
     qh_produceoutput() prints memsizes
+    if qh.qhmem.POOLbuffers, the buffers are chunks of the shared pool
+      (qh_MEMpoolchunk), unless the expected facets fit in one chunk.  For
+      a Delaunay triangulation of n sites in d dimensions, there are about
+      n*d! facets (2n in 2-d, 6.7n in 3-d, 31n in 4-d, 142n in 5-d)
 
 */
 void qh_initqhull_mem(qhT *qh) {
   int numsizes;
   int i;
+  int bufsize= qh_MEMbufsize, bufinit= qh_MEMinitbuf;
+#if qh_MEMpool
+  realT numfacets;
+#endif
 
   numsizes= 8+10;
+#if qh_MEMpool
+  if (qh->qhmem.POOLbuffers) {
+    numfacets= qh->num_points;
+    if (qh->DELAUNAY) {
+      for (i=2; i < qh->hull_dim; i++)
+        numfacets *= i;
+    }
+    if (numfacets * (qh->facet_size + (qh_LEANfacets ? 0 : qh->normal_size)) >= qh_MEMpoolchunk)
+      bufsize= bufinit= qh_MEMpoolchunk;
+    else
+      qh->qhmem.POOLbuffers= False;
+    trace1((qh, qh->ferr, 1068, "qh_initqhull_mem: %2.2g expected facets, short memory buffers of %d bytes %s\n",
+      numfacets, bufsize, (qh->qhmem.POOLbuffers ? "from the pool" : "from qh_malloc")));
+  }
+#endif
   qh_meminitbuffers(qh, qh->IStracing, qh_MEMalign, numsizes,
-                     qh_MEMbufsize, qh_MEMinitbuf);
+                     bufsize, bufinit);
   qh_memsize(qh, (int)sizeof(vertexT));
   if (qh->MERGING) {
     qh_memsize(qh, (int)sizeof(ridgeT));
     qh_memsize(qh, (int)sizeof(mergeT));
   }
-  qh_memsize(qh, (int)sizeof(facetT));
+  qh_memsize(qh, qh->facet_size);          /* facet, .neighbors, .vertices */
   i= sizeof(setT) + (qh->hull_dim - 1) * SETelemsize;  /* ridge.vertices */
   qh_memsize(qh, i);
   qh_memsize(qh, qh->normal_size);        /* normal */
@@ -16,6 +16,9 @@
 */
 
 #include "qhull_ra.h"
+#include "trace.h"
+
+#include <pthread.h>
 
 /*============= functions in alphabetic order after qhull() =======*/
 
@@ -390,11 +393,14 @@ void qh_buildhull(qhT *qh) {
       return;
     }
   }
+  TRACE_BEGIN("qh_buildhull");
   qh->facet_next= qh->facet_list;      /* advance facet when processed */
   while ((furthest= qh_nextfurthest(qh, &facet))) {
     qh->num_outside--;  /* if ONLYmax, furthest may not be outside */
     if (!qh_addpoint(qh, furthest, facet, qh->ONLYmax))
       break;
+    if (qh->progress_fn && (*qh->progress_fn)(qh))
+      qh_errcancel(qh);
   }
   if (qh->NARROWhull) /* move points from outsideset to coplanarset */
     qh_outcoplanar(qh /* facet_list */ );
@@ -402,6 +408,7 @@ void qh_buildhull(qhT *qh) {
     qh_fprintf(qh, qh->ferr, 6167, "qhull internal error (qh_buildhull): %d outside points were never processed.\n", qh->num_outside);
     qh_errexit(qh, qh_ERRqhull, NULL, NULL);
   }
+  TRACE_END("qh_buildhull");
   trace1((qh, qh->ferr, 1039, "qh_buildhull: completed the hull construction\n"));
 } /* buildhull */
 
@@ -541,6 +548,9 @@ void qh_errexit2(qhT *qh, int exitcode, facetT *facet, facetT *otherfacet) {
   see:
     similar to qh_delpoint()
 
+  notes:
+    with 'QE', a neighbor is visible if qh_exactoutside, never coplanar
+
   design:
     move facet to qh.visible_list at end of qh.facet_list
     for all visible facets
@@ -583,7 +593,10 @@ void qh_findhorizon(qhT *qh, pointT *point, facetT *facet, int *goodvisible, int
         continue;
       neighbor->visitid= qh->visit_id;
       zzinc_(Znumvisibility);
-      qh_distplane(qh, point, neighbor, &dist);
+      if (qh->EXACTpredicates)  /* never coplanar */
+        dist= (qh_exactoutside(qh, point, neighbor) ? REALmax : -REALmax);
+      else
+        qh_distplane(qh, point, neighbor, &dist);
       if (dist > qh->MINvisible) {
         zinc_(Ztotvisible);
         qh_removefacet(qh, neighbor);  /* append to end of qh->visible_list */
@@ -773,6 +786,11 @@ pointT *qh_nextfurthest(qhT *qh, facetT **visible) {
       append bestpoint to facet's outside set (furthest)
     for all points remaining in pointset
       partition point into facets' outside sets and coplanar sets
+
+  notes:
+    qh_distplanes computes the distances to each facet at once
+    with 'QE', a point is outside of a facet if qh_exactoutside (one thread),
+    the distances only select the furthest point
 */
 void qh_partitionall(qhT *qh, setT *vertices, pointT *points, int numpoints){
   setT *pointset;
@@ -780,7 +798,7 @@ void qh_partitionall(qhT *qh, setT *vertices, pointT *points, int numpoints){
   pointT *point, **pointp, *bestpoint;
   int size, point_i, point_n, point_end, remaining, i, id;
   facetT *facet;
-  realT bestdist= -REALmax, dist, distoutside;
+  realT bestdist= -REALmax, dist, distoutside, *dists= NULL;
 
   trace1((qh, qh->ferr, 1042, "qh_partitionall: partition all points into outside sets\n"));
   pointset= qh_settemp(qh, numpoints);
@@ -805,16 +823,24 @@ void qh_partitionall(qhT *qh, setT *vertices, pointT *points, int numpoints){
     zval_(Ztotpartition)= qh->num_points - qh->hull_dim - 1; /*misses GOOD... */
     remaining= qh->num_facets;
     point_end= numpoints;
+    if (!qh->RANDOMdist && qh->IStracing < 4)  /* else qh_distplane for each point */
+      dists= (realT *)qh_malloc((size_t)numpoints * sizeof(realT));
     FORALLfacets {
       size= point_end/(remaining--) + 100;
       facet->outsideset= qh_setnew(qh, size);
       bestpoint= NULL;
       point_end= 0;
+      if (dists)
+        qh_distplanes(qh, SETaddr_(pointset, pointT), qh_setsize(qh, pointset), facet, dists);
       FOREACHpoint_i_(qh, pointset) {
         if (point) {
           zzinc_(Zpartitionall);
-          qh_distplane(qh, point, facet, &dist);
-          if (dist < distoutside)
+          if (dists) {
+            zinc_(Zdistplane);
+            dist= dists[point_i];
+          }else
+            qh_distplane(qh, point, facet, &dist);
+          if (qh->EXACTpredicates ? !qh_exactoutside(qh, point, facet) : dist < distoutside)
             SETelem_(pointset, point_end++)= point;
           else {
             qh->num_outside++;
@@ -839,6 +865,7 @@ void qh_partitionall(qhT *qh, setT *vertices, pointT *points, int numpoints){
         qh_setfree(qh, &facet->outsideset);
       qh_settruncate(qh, pointset, point_end);
     }
+    qh_free(dists);
   }
   /* if !qh->BESToutside, pointset contains points not assigned to outsideset */
   if (qh->BESToutside || qh->MERGING || qh->KEEPcoplanar || qh->KEEPinside) {
@@ -857,6 +884,7 @@ void qh_partitionall(qhT *qh, setT *vertices, pointT *points, int numpoints){
 } /* partitionall */
 
 
+
 /*-<a                             href="qh-qhull_r.htm#TOC"
   >-------------------------------</a><a name="partitioncoplanar">-</a>
 
@@ -972,7 +1000,9 @@ void qh_partitioncoplanar(qhT *qh, pointT *point, facetT *facet, realT *dist) {
 
   qh_partitionpoint(qh, point, facet )
     assigns point to an outside set, coplanar set, or inside set (i.e., dropt)
-    if qh.findbestnew
+    if qh.EXACTpredicates ('QE')
+      uses qh_findbestexact()
+    else if qh.findbestnew
       uses qh_findbestnew() to search all new facets
     else
       uses qh_findbest()
@@ -1007,15 +1037,34 @@ void qh_partitionpoint(qhT *qh, pointT *point, facetT *facet) {
   boolT isoutside;
   facetT *bestfacet;
   int numpart;
-#if qh_COMPUTEfurthest
-  realT dist;
-#endif
 
-  if (qh->findbestnew)
+  if (qh->EXACTpredicates)
+    bestfacet= qh_findbestexact(qh, point, facet, &bestdist, &isoutside, &numpart);
+  else if (qh->findbestnew)
     bestfacet= qh_findbestnew(qh, point, facet, &bestdist, qh->BESToutside, &isoutside, &numpart);
   else
     bestfacet= qh_findbest(qh, point, facet, qh->BESToutside, qh_ISnewfacets, !qh_NOupper,
                           &bestdist, &isoutside, &numpart);
+  qh_partitionfound(qh, point, bestfacet, bestdist, isoutside, numpart);
+} /* partitionpoint */
+
+/*-<a                             href="qh-qhull_r.htm#TOC"
+  >-------------------------------</a><a name="partitionfound">-</a>
+
+  qh_partitionfound(qh, point, bestfacet, bestdist, isoutside, numpart )
+    assigns point to bestfacet, as found by qh_findbestnew() or qh_findbest()
+    bestdist is the distance to bestfacet, isoutside is True if outside
+    numpart is the number of distance tests of the search
+
+  notes:
+    the second half of qh_partitionpoint
+*/
+void qh_partitionfound(qhT *qh, pointT *point, facetT *bestfacet, realT bestdist,
+           boolT isoutside, int numpart) {
+#if qh_COMPUTEfurthest
+  realT dist;
+#endif
+
   zinc_(Ztotpartition);
   zzadd_(Zpartition, numpart);
   if (qh->NARROWhull) {
@@ -1078,7 +1127,291 @@ void qh_partitionpoint(qhT *qh, pointT *point, facetT *facet) {
     if (qh->KEEPinside)
       qh_partitioncoplanar(qh, point, bestfacet, &bestdist);
   }
-} /* partitionpoint */
+} /* partitionfound */
+
+/*-<a                             href="qh-qhull_r.htm#TOC"
+  >-------------------------------</a><a name="partitionbatch">-</a>
+
+  qh_partitionbatch(qh, batch )
+    scans qh.newfacet_list for the outside points of qh.visible_list,
+    as the first loop of qh_findbestnew, with up to qh.NUMthreads threads
+
+  returns:
+    False if not worth it or out of memory (nothing done)
+    otherwise True and, for each outside point in the order of
+    qh_partitionvisible, the scans of the new facets from its start facet
+    to the end of qh.newfacet_list, and from qh.newfacet_list to its start facet
+
+  notes:
+    only with qh.findbestnew (qh_findbest is a directed search)
+    the threads only do the distance tests (qh_distfacets)
+    qh_findbestbatch replays qh_findbestnew on the scans
+
+  design:
+    collect the new facets, the outside points, and their start facets
+    for each point, in threads
+      scan the new facets from its start facet, then up to it
+*/
+typedef struct {
+  int      best;       /* index of the best facet, -1 if none */
+  int      numpart;    /* number of distance tests */
+  realT    dist;       /* distance to the best facet */
+  boolT    isearly;    /* True if clearly outside of best (early out) */
+} qh_scanT;
+
+typedef struct {
+  facetT **newfacets;  /* qh.newfacet_list */
+  int      numnew;
+  facetT  *lastnew;    /* last new facet, before facets moved by qh_partitionpoint */
+  realT    distoutside; /* qh_DISToutside of the scans */
+  pointT **points;     /* outside points of the visible facets */
+  int     *startof;    /* index of the start facet of each point */
+  qh_scanT *scans;     /* two scans per point */
+  int      numpoints;
+} qh_batchT;
+
+typedef struct {
+  qh_batchT *batch;
+  qhT      *qh;
+  int       start;
+  int       end;
+} qh_batchjobT;
+
+static void qh_scannew(qhT *qh, qh_batchT *batch, pointT *point, int from, int to, qh_scanT *scan) {
+  facetT *facet;
+  realT dists[qh_DISTbatch];
+  int i, j, size;
+
+  scan->best= -1;
+  scan->numpart= 0;
+  scan->dist= -REALmax/2;
+  scan->isearly= False;
+  for (i=from; i < to; i += size) {
+    size= to - i < qh_DISTbatch ? to - i : qh_DISTbatch;
+    qh_distfacets(qh, point, batch->newfacets+i, size, dists);
+    for (j=0; j < size; j++) {
+      facet= batch->newfacets[i+j];
+      if (!facet->flipped) {
+        scan->numpart++;
+        if (dists[j] > scan->dist) {
+          if (!facet->upperdelaunay || dists[j] >= qh->MINoutside) {  /* as qh_findbestnew */
+            scan->best= i+j;
+            if (dists[j] >= batch->distoutside) {
+              scan->dist= dists[j];
+              scan->isearly= True;
+              return;
+            }
+            scan->dist= dists[j];
+          }
+        }
+      }
+    }
+  }
+} /* scannew */
+
+static void qh_freebatch(qh_batchT *batch) {
+  qh_free(batch->newfacets);
+  qh_free(batch->points);
+  qh_free(batch->startof);
+  qh_free(batch->scans);
+  batch->newfacets= NULL;
+  batch->points= NULL;
+  batch->startof= NULL;
+  batch->scans= NULL;
+} /* freebatch */
+
+static void *qh_partitionbatchjob(void *arg) {
+  qh_batchjobT *job= (qh_batchjobT *)arg;
+  qh_batchT *batch= job->batch;
+  int k, start;
+
+  TRACE_BEGIN("qh_partitionbatchjob");
+  for (k=job->start; k < job->end; k++) {
+    start= batch->startof[k];
+    qh_scannew(job->qh, batch, batch->points[k], start, batch->numnew, &batch->scans[2*k]);
+    if (!batch->scans[2*k].isearly)
+      qh_scannew(job->qh, batch, batch->points[k], 0, start, &batch->scans[2*k+1]);
+  }
+  TRACE_END("qh_partitionbatchjob");
+  return NULL;
+} /* partitionbatchjob */
+
+static boolT qh_partitionbatch(qhT *qh, qh_batchT *batch) {
+  facetT *visible, *newfacet;
+  pointT *point, **pointp;
+  int numnew= 0, numpoints= 0, numthreads, chunk, i, k, t;
+  unsigned int count;
+  pthread_t *threads;
+  boolT *started;
+  qh_batchjobT *jobs;
+
+  FORALLvisible_facets {
+    if (visible->outsideset)
+      numpoints += qh_setsize(qh, visible->outsideset);
+  }
+  FORALLnew_facets
+    numnew++;
+  numthreads= (int)((double)numpoints * numnew / qh_PARTITIONvisible);
+  minimize_(numthreads, qh->NUMthreads);
+  if (numthreads < 2)
+    return False;
+  batch->numnew= numnew;
+  batch->numpoints= numpoints;
+  batch->lastnew= qh->facet_tail->previous;
+  batch->distoutside= qh_DISToutside;
+  batch->newfacets= (facetT **)qh_malloc((size_t)numnew * sizeof(facetT *));
+  batch->points= (pointT **)qh_malloc((size_t)numpoints * sizeof(pointT *));
+  batch->startof= (int *)qh_malloc((size_t)numpoints * sizeof(int));
+  batch->scans= (qh_scanT *)qh_malloc((size_t)(2*numpoints) * sizeof(qh_scanT));
+  threads= (pthread_t *)qh_malloc((size_t)numthreads * sizeof(pthread_t));
+  started= (boolT *)qh_malloc((size_t)numthreads * sizeof(boolT));
+  jobs= (qh_batchjobT *)qh_malloc((size_t)numthreads * sizeof(qh_batchjobT));
+  if (!batch->newfacets || !batch->points || !batch->startof || !batch->scans
+  || !threads || !started || !jobs) {
+    qh_free(threads); qh_free(started); qh_free(jobs);
+    qh_freebatch(batch);
+    return False;
+  }
+  i= 0;
+  FORALLnew_facets
+    batch->newfacets[i++]= newfacet;
+  k= 0;
+  FORALLvisible_facets {  /* the start facets of qh_partitionvisible */
+    if (!visible->outsideset)
+      continue;
+    newfacet= visible->f.replace;
+    count= 0;
+    while (newfacet && newfacet->visible) {
+      newfacet= newfacet->f.replace;
+      if (count++ > qh->facet_id)
+        break;  /* qh_partitionvisible reports the infinite loop */
+    }
+    if (!newfacet || newfacet->visible)
+      newfacet= qh->newfacet_list;
+    for (i=0; i < numnew; i++) {
+      if (batch->newfacets[i] == newfacet)
+        break;
+    }
+    if (i == numnew) {  /* reported by qh_partitionvisible */
+      qh_free(threads); qh_free(started); qh_free(jobs);
+      qh_freebatch(batch);
+      return False;
+    }
+    FOREACHpoint_(visible->outsideset) {
+      batch->points[k]= point;
+      batch->startof[k++]= i;
+    }
+  }
+  chunk= (numpoints + numthreads - 1) / numthreads;
+  for (t=0; t < numthreads; t++) {
+    jobs[t].batch= batch;
+    jobs[t].qh= qh;
+    jobs[t].start= t * chunk;
+    jobs[t].end= (t+1) * chunk < numpoints ? (t+1) * chunk : numpoints;
+  }
+  for (t=1; t < numthreads; t++)  /* if a thread can not start, its job is done below */
+    started[t]= !pthread_create(&threads[t], NULL, qh_partitionbatchjob, &jobs[t]);
+  qh_partitionbatchjob(&jobs[0]);
+  for (t=1; t < numthreads; t++) {
+    if (started[t])
+      pthread_join(threads[t], NULL);
+    else
+      qh_partitionbatchjob(&jobs[t]);
+  }
+  qh_free(threads); qh_free(started); qh_free(jobs);
+  zinc_(Zpartbatch);
+  trace2((qh, qh->ferr, 2125, "qh_partitionbatch: scanned %d new facets for %d points with %d threads\n",
+    numnew, numpoints, numthreads));
+  return True;
+} /* partitionbatch */
+
+/*-<a                             href="qh-qhull_r.htm#TOC"
+  >-------------------------------</a><a name="findbestbatch">-</a>
+
+  qh_findbestbatch(qh, batch, k, startfacet, dist, isoutside, numpart )
+    qh_findbestnew for the k-th point of qh_partitionbatch
+
+  returns:
+    as qh_findbestnew(qh, point, startfacet, dist, !qh_ALL, isoutside, numpart)
+
+  notes:
+    the scans are the visits of qh_findbestnew; the facets moved after
+    batch->lastnew by qh_partitionpoint are visited between the two scans,
+    as qh_findbestnew does
+    the running maximum of a scan from -REALmax/2 is the one of the scan
+    from the best distance before it, if greater; its early out is the same
+    requires the qh_DISToutside of the scans
+
+  design:
+    replay the first scan
+    visit the moved facets
+    replay the second scan
+    search the horizon as qh_findbestnew
+*/
+static facetT *qh_findbestbatch(qhT *qh, qh_batchT *batch, int k, facetT *startfacet,
+           realT *dist, boolT *isoutside, int *numpart) {
+  qh_scanT *scan= &batch->scans[2*k];
+  realT bestdist= -REALmax/2;
+  facetT *bestfacet= NULL, *facet;
+  pointT *point= batch->points[k];
+  unsigned int visitid= ++qh->visit_id;
+  int start= batch->startof[k], i, last, numscanned;
+
+  zinc_(Zfindnew);
+  zinc_(Zfindnewbatch);
+  *isoutside= True;
+  *numpart= numscanned= scan->numpart;
+  last= scan->isearly ? scan->best+1 : batch->numnew;
+  for (i=start; i < last; i++)
+    batch->newfacets[i]->visitid= visitid;
+  if (scan->best >= 0) {
+    bestfacet= batch->newfacets[scan->best];
+    bestdist= scan->dist;
+  }
+  if (scan->isearly) {
+    *dist= bestdist;
+    goto LABELreturn_bestbatch;
+  }
+  for (facet=batch->lastnew->next; facet != qh->facet_tail; facet= facet->next) {
+    facet->visitid= visitid;
+    if (!facet->flipped) {
+      qh_distplane(qh, point, facet, dist);
+      (*numpart)++;
+      if (*dist > bestdist) {
+        if (!facet->upperdelaunay || *dist >= qh->MINoutside) {
+          bestfacet= facet;
+          if (*dist >= batch->distoutside)
+            goto LABELreturn_bestbatch;
+          bestdist= *dist;
+        }
+      }
+    }
+  }
+  scan++;
+  *numpart += scan->numpart;
+  numscanned += scan->numpart;
+  last= scan->isearly ? scan->best+1 : start;
+  for (i=0; i < last; i++)
+    batch->newfacets[i]->visitid= visitid;
+  if (scan->best >= 0 && (scan->isearly || scan->dist > bestdist)) {
+    bestfacet= batch->newfacets[scan->best];
+    bestdist= scan->dist;
+  }
+  if (scan->isearly) {
+    *dist= bestdist;
+    goto LABELreturn_bestbatch;
+  }
+  bestfacet= qh_findbesthorizon(qh, !qh_IScheckmax, point, bestfacet ? bestfacet : startfacet,
+                                      !qh_NOupper, &bestdist, numpart);
+  *dist= bestdist;
+  if (*dist < qh->MINoutside)
+    *isoutside= False;
+LABELreturn_bestbatch:
+  zadd_(Zdistplane, numscanned);
+  zadd_(Zfindnewtot, *numpart);
+  zmax_(Zfindnewmax, *numpart);
+  return bestfacet;
+} /* findbestbatch */
 
 /*-<a                             href="qh-qhull_r.htm#TOC"
   >-------------------------------</a><a name="partitionvisible">-</a>
@@ -1097,12 +1430,17 @@ void qh_partitionpoint(qhT *qh, pointT *point, facetT *facet) {
 
   notes:
     qh.findbest_notsharp should be clear (extra work if set)
+    with qh.findbestnew and qh.NUMthreads > 1, the distance tests of
+    qh_findbestnew for the outside points are done by qh_partitionbatch,
+    and qh_findbestbatch replays them in the same order (not with 'QE')
 
   design:
+    if qh.findbestnew and multiple threads
+      scan the new facets for all outside points in parallel
     for all visible facets with outside set or coplanar set
       select a newfacet for visible facet
       if outside set
-        partition outside set into new facets
+        partition outside set into new facets (maybe from the scans)
       if coplanar set and keeping coplanar/near-inside/inside points
         if allpoints
           partition coplanar set into new facets, may be assigned outside
@@ -1115,15 +1453,21 @@ void qh_partitionpoint(qhT *qh, pointT *point, facetT *facet) {
         partition vertex into coplanar sets of new facets
 */
 void qh_partitionvisible(qhT *qh /*qh.visible_list*/, boolT allpoints, int *numoutside) {
-  facetT *visible, *newfacet;
+  facetT *visible, *newfacet, *bestfacet;
   pointT *point, **pointp;
-  int coplanar=0, size;
+  int coplanar=0, size, numbatched= 0, numpart;
   unsigned count;
   vertexT *vertex, **vertexp;
+  qh_batchT batch;
+  boolT isbatch= False, isoutside;
+  realT bestdist;
 
   if (qh->ONLYmax)
     maximize_(qh->MINoutside, qh->max_vertex);
   *numoutside= 0;
+  if (qh->findbestnew && !qh->BESToutside && qh->NUMthreads > 1 && !qh->RANDOMdist
+  && qh->IStracing < 3 && !qh->TRACElevel && !qh->EXACTpredicates)
+    isbatch= qh_partitionbatch(qh, &batch);
   FORALLvisible_facets {
     if (!visible->outsideset && !visible->coplanarset)
       continue;
@@ -1144,8 +1488,14 @@ void qh_partitionvisible(qhT *qh /*qh.visible_list*/, boolT allpoints, int *numo
       size= qh_setsize(qh, visible->outsideset);
       *numoutside += size;
       qh->num_outside -= size;
-      FOREACHpoint_(visible->outsideset)
-        qh_partitionpoint(qh, point, newfacet);
+      FOREACHpoint_(visible->outsideset) {
+        if (isbatch && numbatched < batch.numpoints && batch.points[numbatched] == point && batch.distoutside == qh_DISToutside) {
+          bestfacet= qh_findbestbatch(qh, &batch, numbatched, newfacet, &bestdist, &isoutside, &numpart);
+          qh_partitionfound(qh, point, bestfacet, bestdist, isoutside, numpart);
+        }else
+          qh_partitionpoint(qh, point, newfacet);
+        numbatched++;  /* points[] is in the same order */
+      }
     }
     if (visible->coplanarset && (qh->KEEPcoplanar + qh->KEEPinside + qh->KEEPnearinside)) {
       size= qh_setsize(qh, visible->coplanarset);
@@ -1166,6 +1516,8 @@ void qh_partitionvisible(qhT *qh /*qh.visible_list*/, boolT allpoints, int *numo
         qh_partitioncoplanar(qh, vertex->point, qh->newfacet_list, NULL);
     }
   }
+  if (isbatch)
+    qh_freebatch(&batch);
   trace1((qh, qh->ferr, 1043,"qh_partitionvisible: partitioned %d points from outsidesets and %d points from coplanarsets\n", *numoutside, coplanar));
 } /* partitionvisible */
 
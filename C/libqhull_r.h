@@ -184,6 +184,7 @@ typedef enum {qh_PRINTnone= 0,
 #define qh_ERRprec  3    /* precision error */
 #define qh_ERRmem   4    /* insufficient memory, matches mem_r.h */
 #define qh_ERRqhull 5    /* internal error detected, matches mem_r.h */
+#define qh_ERRcancel 6   /* cancelled by qh.progress_fn */
 
 /*-<a                             href="qh-qhull_r.htm#TOC"
 >--------------------------------</a><a name="qh_FILEstderr">-</a>
@@ -269,6 +270,7 @@ struct facetT {
   coordT   offset;      /* exact offset of hyperplane from origin */
   coordT  *normal;      /* normal of hyperplane, hull_dim coefficients */
                         /*   if ->tricoplanar, shared with a neighbor */
+                        /*   if qh_LEANfacets, usually stored after the facet (qh_INLINEnormal_) */
   union {               /* in order of testing */
    realT   area;        /* area of facet, only in io_r.c if  ->isarea */
    facetT *replace;     /*  replacement facet if ->visible and NEWfacets
@@ -458,6 +460,7 @@ struct qhT {
   boolT DELAUNAY;         /* true 'd' if computing DELAUNAY triangulation */
   boolT DOintersections;  /* true 'Gh' if print hyperplane intersections */
   int   DROPdim;          /* drops dim 'GDn' for 4-d -> 3-d output */
+  boolT EXACTpredicates;  /* true 'QE' if exact predicates, without merging (predicates_r.c) */
   boolT FORCEoutput;      /* true 'Po' if forcing output despite degeneracies */
   int   GOODpoint;        /* 1+n for 'QGn', good facet if visible/not(-) from point n*/
   pointT *GOODpointp;     /*   the actual point */
@@ -630,6 +633,8 @@ struct qhT {
   pointT *interior_point; /* center point of the initial simplex*/
   int normal_size;     /* size in bytes for facet normals and point coords*/
   int center_size;     /* size in bytes for Voronoi centers */
+  int facet_size;      /* size in bytes for a facet and its inline sets, see qh_newfacet */
+  int exact_offset;    /* offset of qh_EXACTplane_ in a facet, for 'QE' */
   int   TEMPsize;         /* size for small, temporary sets (in quick mem) */
 
 /*-<a                             href="qh-globa_r.htm#TOC"
@@ -726,6 +731,13 @@ struct qhT {
   setT *degen_mergeset;   /* temporary set of degenerate and redundant merges */
   setT *hash_table;       /* hash table for matching ridges in qh_matchfacets
                              size is setsize() */
+  unsigned *newhash;      /* open-addressing table for matching the ridges of
+                             new facets in qh_matchnewfacets, see qh_newhash.
+                             Hash codes of the ridges, 0 if empty */
+  facetT **newhashfacets; /* facet of each nonempty entry of qh.newhash */
+  int   newhashsize;      /* number of entries of qh.newhash, a power of 2 */
+  int   newhashshift;     /* 32 - log2(newhashsize), for qh_HASHslot */
+  int   newhashcount;     /* number of nonempty entries of qh.newhash */
   setT *other_points;     /* additional points */
   setT *del_vertices;     /* vertices to partition and delete with visible
                              facets.  Have deleted set for checkfacet */
@@ -780,6 +792,10 @@ struct qhT {
   int     rbox_isinteger;
   double  rbox_out_offset;
   void *  cpp_object;     /* C++ pointer.  Currently used by RboxPoints.qh_fprintf_rbox */
+  void *  progress_object; /* user data for progress_fn, e.g. ProgressT in delaunay.c */
+  boolT (*progress_fn)(qhT *qh); /* if not NULL, called by qh_buildhull after each point and by qh_triangulate
+                             after each facet; returns True to cancel with qh_errcancel() */
+  int     NUMthreads;     /* if > 1, number of threads for the distance tests of qh_partitionvisible */
 
   /* Last, otherwise zero'd by qh_initqhull_start2 (global_r.c */
   qhmemT  qhmem;          /* Qhull managed memory (mem_r.h) */
@@ -1029,6 +1045,7 @@ void    qh_printsummary(qhT *qh, FILE *fp);
 
 /********* -user.c prototypes (alphabetical) **********************/
 
+void    qh_errcancel(qhT *qh);
 void    qh_errexit(qhT *qh, int exitcode, facetT *facet, ridgeT *ridge);
 void    qh_errprint(qhT *qh, const char* string, facetT *atfacet, facetT *otherfacet, ridgeT *atridge, vertexT *atvertex);
 int     qh_new_qhull(qhT *qh, int dim, int numpoints, coordT *points, boolT ismalloc,
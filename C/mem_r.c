@@ -18,6 +18,10 @@
   To free up all memory buffers:
     qh_memfreeshort(qh, &curlong, &totlong);
 
+  To draw the memory buffers from the pool shared by all qhT (qh_MEMpool):
+    qh->qhmem.POOLbuffers= True;  after qh_meminit
+    qh_mempoolrelease();  frees the idle chunks of the pool
+
   if qh_NOmem,
     malloc/free is used instead of mem.c
 
@@ -39,12 +43,32 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#if qh_MEMpool
+#include <pthread.h>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+#endif
+
+/*============= pool of short memory buffers ==============*/
+
+#if qh_MEMpool
+static pthread_mutex_t qh_mempoollock= PTHREAD_MUTEX_INITIALIZER;
+static void *qh_mempoolchunks= NULL; /* idle chunks, linked by offset 0 */
+static int qh_mempoolcount= 0;       /* number of idle chunks */
+
+static void qh_mempoolfree(void *chunk);
+#endif
 
 #ifndef qh_NOmem
 
 /*============= internal functions ==============*/
 
 static int qh_intcompare(const void *i, const void *j);
+#if qh_MEMpool
+static void *qh_mempoolget(qhT *qh);
+static void qh_mempoolput(void *chunk);
+#endif
 
 /*========== functions in alphabetical order ======== */
 
@@ -122,7 +146,13 @@ void *qh_memalloc(qhT *qh, int insize) {
           bufsize= qh->qhmem.BUFinit;
         else
           bufsize= qh->qhmem.BUFsize;
-        if (!(newbuffer= qh_malloc((size_t)bufsize))) {
+#if qh_MEMpool
+        if (qh->qhmem.POOLbuffers)
+          newbuffer= qh_mempoolget(qh);  /* bufsize is qh_MEMpoolchunk */
+        else
+#endif
+          newbuffer= qh_malloc((size_t)bufsize);
+        if (!newbuffer) {
           qh_fprintf(qh, qh->qhmem.ferr, 6080, "qhull error (qh_memalloc): insufficient memory to allocate short memory buffer (%d bytes)\n", bufsize);
           qh_errexit(qh, qhmem_ERRmem, NULL, NULL);
         }
@@ -264,6 +294,7 @@ void qh_memfree(qhT *qh, void *object, int insize) {
     number and size of current long allocations
 
   notes:
+    if qh.qhmem.POOLbuffers, returns the buffers to the pool of chunks
     if qh_NOmem (qh_malloc() for all allocations),
        short objects (e.g., facetT) are not recovered.
        use qh_freeqhull(qh, qh_ALL) instead.
@@ -280,6 +311,12 @@ void qh_memfreeshort(qhT *qh, int *curlong, int *totlong) {
   *totlong= qh->qhmem.totlong;
   for (buffer= qh->qhmem.curbuffer; buffer; buffer= nextbuffer) {
     nextbuffer= *((void **) buffer);
+#if qh_MEMpool
+    if (qh->qhmem.POOLbuffers) {
+      qh_mempoolput(buffer);
+      continue;
+    }
+#endif
     qh_free(buffer);
   }
   qh->qhmem.curbuffer= NULL;
@@ -351,6 +388,71 @@ void qh_meminitbuffers(qhT *qh, int tracelevel, int alignment, int numsizes, int
     qh_fprintf(qh, qh->qhmem.ferr, 8059, "qh_meminitbuffers: memory initialized with alignment %d\n", alignment);
 } /* meminitbuffers */
 
+#if qh_MEMpool
+/*-<a                             href="qh-mem_r.htm#TOC"
+  >-------------------------------</a><a name="mempoolget">-</a>
+
+  qh_mempoolget(qh)
+    return a chunk of qh_MEMpoolchunk bytes for a short memory buffer
+
+  returns:
+    an idle chunk of the pool, if any
+    otherwise a new chunk, or NULL if insufficient memory
+
+  notes:
+    the pages of an idle chunk were touched by a previous qhT, they do not fault
+    on Linux, a new chunk is aligned to its size and advised for transparent
+      huge pages (one TLB entry per chunk on x86-64)
+*/
+static void *qh_mempoolget(qhT *qh) {
+  void *chunk;
+  int count;
+
+  pthread_mutex_lock(&qh_mempoollock);
+  if ((chunk= qh_mempoolchunks)) {
+    qh_mempoolchunks= *((void **)chunk);
+    qh_mempoolcount--;
+  }
+  count= qh_mempoolcount;
+  pthread_mutex_unlock(&qh_mempoollock);
+  if (!chunk) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (posix_memalign(&chunk, (size_t)qh_MEMpoolchunk, (size_t)qh_MEMpoolchunk))
+      return NULL;
+    madvise(chunk, (size_t)qh_MEMpoolchunk, MADV_HUGEPAGE);  /* a hint, errors are ignored */
+#else
+    chunk= qh_malloc((size_t)qh_MEMpoolchunk);
+#endif
+  }
+  if (qh->qhmem.IStracing >= 5)
+    qh_fprintf(qh, qh->qhmem.ferr, 8147, "qh_mem %p chunk of the pool, %d idle chunks left\n", chunk, count);
+  return chunk;
+} /* mempoolget */
+
+/*-<a                             href="qh-mem_r.htm#TOC"
+  >-------------------------------</a><a name="mempoolput">-</a>
+
+  qh_mempoolput(chunk)
+    return a chunk from qh_mempoolget to the pool
+
+  notes:
+    frees the chunk if the pool has qh_MEMpoolmax idle chunks
+*/
+static void qh_mempoolput(void *chunk) {
+
+  pthread_mutex_lock(&qh_mempoollock);
+  if (qh_mempoolcount < qh_MEMpoolmax) {
+    *((void **)chunk)= qh_mempoolchunks;
+    qh_mempoolchunks= chunk;
+    qh_mempoolcount++;
+    chunk= NULL;
+  }
+  pthread_mutex_unlock(&qh_mempoollock);
+  if (chunk)
+    qh_mempoolfree(chunk);
+} /* mempoolput */
+#endif /* qh_MEMpool */
+
 /*-<a                             href="qh-mem_r.htm#TOC"
   >-------------------------------</a><a name="memsetup">-</a>
 
@@ -540,6 +642,49 @@ void qh_memstatistics(qhT *qh, FILE *fp) {
 
 #endif /* qh_NOmem */
 
+#if qh_MEMpool
+/*-<a                             href="qh-mem_r.htm#TOC"
+  >-------------------------------</a><a name="mempoolfree">-</a>
+
+  qh_mempoolfree(chunk)
+    free a chunk of the pool
+*/
+static void qh_mempoolfree(void *chunk) {
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  free(chunk);  /* from posix_memalign */
+#else
+  qh_free(chunk);
+#endif
+} /* mempoolfree */
+#endif /* qh_MEMpool */
+
+/*-<a                             href="qh-mem_r.htm#TOC"
+  >-------------------------------</a><a name="mempoolrelease">-</a>
+
+  qh_mempoolrelease()
+    free the idle chunks of the pool of short memory buffers
+
+  notes:
+    the chunks in use by a qhT are not freed, qh_memfreeshort returns them
+    may be called at any time, from any thread
+*/
+void qh_mempoolrelease(void) {
+#if qh_MEMpool
+  void *chunk, *nextchunk;
+
+  pthread_mutex_lock(&qh_mempoollock);
+  chunk= qh_mempoolchunks;
+  qh_mempoolchunks= NULL;
+  qh_mempoolcount= 0;
+  pthread_mutex_unlock(&qh_mempoollock);
+  for (; chunk; chunk= nextchunk) {
+    nextchunk= *((void **)chunk);
+    qh_mempoolfree(chunk);
+  }
+#endif
+} /* mempoolrelease */
+
 /*-<a                             href="qh-mem_r.htm#TOC"
 >-------------------------------</a><a name="memtotlong">-</a>
 
@@ -148,6 +148,10 @@ struct qhmemT {               /* global memory management variables */
   int      totunused;         /* total unused short memory (estimated, short size - request size of first allocations) */
   int      cntlarger;         /* count of setlarger's */
   int      totlarger;         /* total copied by setlarger */
+  int      POOLbuffers;       /* True if the buffers come from the pool of
+                                 chunks shared by all qhT (qh_MEMpool).  Set
+                                 by the caller after qh_meminit, reset by
+                                 qh_initqhull_mem for small inputs */
 };
 
 
@@ -222,6 +226,7 @@ void qh_memfreeshort(qhT *qh, int *curlong, int *totlong);
 void qh_meminit(qhT *qh, FILE *ferr);
 void qh_meminitbuffers(qhT *qh, int tracelevel, int alignment, int numsizes,
                         int bufsize, int bufinit);
+void qh_mempoolrelease(void);
 void qh_memsetup(qhT *qh);
 void qh_memsize(qhT *qh, int size);
 void qh_memstatistics(qhT *qh, FILE *fp);
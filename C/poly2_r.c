@@ -14,6 +14,7 @@
 */
 
 #include "qhull_ra.h"
+#include "trace.h"
 
 /*======== functions in alphabetical order ==========*/
 
@@ -37,6 +38,30 @@ void qh_addhash(void *newelem, setT *hashtable, int hashsize, int hash) {
     SETelem_(hashtable, scan)= newelem;
 } /* addhash */
 
+/*-<a                             href="qh-poly_r.htm#TOC"
+  >-------------------------------</a><a name="addnewhash">-</a>
+
+  qh_addnewhash(qh, facet, code )
+    add facet to qh.newhash for a ridge with this code, if not already there
+
+  notes:
+    code is not 0
+    may grow qh.newhash (qh_growhash)
+*/
+void qh_addnewhash(qhT *qh, facetT *facet, unsigned code) {
+  int scan, mask= qh->newhashsize - 1;
+  unsigned other;
+
+  for (scan= qh_HASHslot(qh, code); (other= qh->newhash[scan]); scan= (scan+1) & mask) {
+    if (other == code && qh->newhashfacets[scan] == facet)
+      return;
+  }
+  qh->newhash[scan]= code;
+  qh->newhashfacets[scan]= facet;
+  if (++qh->newhashcount > qh->newhashsize/4*3)
+    qh_growhash(qh);
+} /* addnewhash */
+
 /*-<a                             href="qh-poly_r.htm#TOC"
   >-------------------------------</a><a name="check_bestdist">-</a>
 
@@ -304,7 +329,12 @@ void qh_check_output(qhT *qh) {
 
   if (qh->STOPcone)
     return;
-  if (qh->VERIFYoutput | qh->IStracing | qh->CHECKfrequently) {
+  if (qh->EXACTpredicates) {
+    if (qh->VERIFYoutput | qh->IStracing | qh->CHECKfrequently) {
+      qh_checkpolygon(qh, qh->facet_list);
+      qh_checkexact(qh, qh->facet_list);
+    }
+  }else if (qh->VERIFYoutput | qh->IStracing | qh->CHECKfrequently) {
     qh_checkpolygon(qh, qh->facet_list);
     qh_checkflipped_all(qh, qh->facet_list);
     qh_checkconvex(qh, qh->facet_list, qh_ALGORITHMfault);
@@ -586,6 +616,50 @@ void qh_checkconvex(qhT *qh, facetT *facetlist, int fault) {
     qh_errexit2(qh, qh_ERRprec, errfacet1, errfacet2);
 } /* checkconvex */
 
+/*-<a                             href="qh-poly_r.htm#TOC"
+  >-------------------------------</a><a name="checkexact">-</a>
+
+  qh_checkexact(qh, facetlist )
+    checks that the facets of facetlist are locally convex with exact
+    predicates ('QE')
+
+  notes:
+    called by qh_initialhull and qh_check_output instead of qh_checkconvex
+    a simplicial neighbor has one vertex that is not a vertex of the facet
+    the hull is convex if this vertex is never above the facet
+
+  design:
+    for each facet
+      for each neighbor
+        find the vertex of the neighbor that is not a vertex of the facet
+        report an error if it is above the facet (qh_exactoutside)
+*/
+void qh_checkexact(qhT *qh, facetT *facetlist) {
+  facetT *facet, *neighbor, **neighborp, *errfacet1= NULL, *errfacet2= NULL;
+  vertexT *vertex, **vertexp;
+
+  trace1((qh, qh->ferr, 1071, "qh_checkexact: check that facets are convex with exact predicates\n"));
+  FORALLfacet_(facetlist) {
+    if (facet->visible)
+      continue;
+    FOREACHneighbor_(facet) {
+      FOREACHvertex_(neighbor->vertices) {
+        if (!qh_setin(facet->vertices, vertex))
+          break;
+      }
+      zzinc_(Zdistconvex);
+      if (vertex && qh_exactoutside(qh, vertex->point, facet)) {
+        qh_fprintf(qh, qh->ferr, 6276, "qhull internal error (qh_checkexact): p%d(v%d) of f%d is above its neighbor f%d with exact predicates\n",
+          qh_pointid(qh, vertex->point), vertex->id, neighbor->id, facet->id);
+        errfacet1= facet;
+        errfacet2= neighbor;
+      }
+    }
+  }
+  if (errfacet1)
+    qh_errexit2(qh, qh_ERRqhull, errfacet1, errfacet2);
+} /* checkexact */
+
 
 /*-<a                             href="qh-poly_r.htm#TOC"
   >-------------------------------</a><a name="checkfacet">-</a>
@@ -1091,8 +1165,8 @@ void qh_createsimplex(qhT *qh, setT *vertices) {
   qh->vertex_list= qh->newvertex_list= qh->vertex_tail= qh_newvertex(qh, NULL);
   FOREACHvertex_i_(qh, vertices) {
     newfacet= qh_newfacet(qh);
-    newfacet->vertices= qh_setnew_delnthsorted(qh, vertices, vertex_n,
-                                                vertex_i, 0);
+    newfacet->vertices= qh_newfacetvertices(qh, newfacet,
+             qh_setnew_delnthsorted(qh, vertices, vertex_n, vertex_i, 0));
     newfacet->toporient= (unsigned char)toporient;
     qh_appendfacet(qh, newfacet);
     newfacet->newfacet= True;
@@ -1565,6 +1639,24 @@ void qh_findgood_all(qhT *qh, facetT *facetlist) {
         numgood, startgood));
 } /* findgood_all */
 
+/*-<a                             href="qh-poly_r.htm#TOC"
+  >-------------------------------</a><a name="freenewhash">-</a>
+
+  qh_freenewhash(qh )
+    free qh.newhash, if any
+*/
+void qh_freenewhash(qhT *qh) {
+
+  if (qh->newhash) {
+    qh_memfree(qh, qh->newhash, qh->newhashsize * (int)sizeof(unsigned));
+    qh_memfree(qh, qh->newhashfacets, qh->newhashsize * (int)sizeof(facetT *));
+    qh->newhash= NULL;
+    qh->newhashfacets= NULL;
+    qh->newhashsize= 0;
+    qh->newhashcount= 0;
+  }
+} /* freenewhash */
+
 /*-<a                             href="qh-poly_r.htm#TOC"
   >-------------------------------</a><a name="furthestnext">-</a>
 
@@ -1643,6 +1735,45 @@ void qh_furthestout(qhT *qh, facetT *facet) {
 } /* furthestout */
 
 
+/*-<a                             href="qh-poly_r.htm#TOC"
+  >-------------------------------</a><a name="growhash">-</a>
+
+  qh_growhash(qh )
+    double the size of qh.newhash
+
+  notes:
+    called by qh_addnewhash and qh_matchneighbor past 3/4 full,
+    usually for many duplicate ridges (see qh_newhash)
+*/
+void qh_growhash(qhT *qh) {
+  unsigned *codes= qh->newhash, code;
+  facetT **facets= qh->newhashfacets;
+  int size= qh->newhashsize, i, scan, mask;
+
+  trace2((qh, qh->ferr, 2126, "qh_growhash: %d entries of %d, double the size\n",
+    qh->newhashcount, size));
+  if (size > INT_MAX/(2 * (int)sizeof(facetT *))) {
+    qh_fprintf(qh, qh->qhmem.ferr, 6431, "qhull error (qh_growhash): overflow of qh.newhash (%d entries).  Did int overflow due to high-D?\n", size); /* WARN64 */
+    qh_errexit(qh, qhmem_ERRmem, NULL, NULL);
+  }
+  qh->newhashsize= 2 * size;
+  qh->newhashshift--;
+  qh->newhash= (unsigned *)qh_memalloc(qh, qh->newhashsize * (int)sizeof(unsigned));
+  qh->newhashfacets= (facetT **)qh_memalloc(qh, qh->newhashsize * (int)sizeof(facetT *));
+  memset((char *)qh->newhash, 0, (size_t)qh->newhashsize * sizeof(unsigned));
+  mask= qh->newhashsize - 1;
+  for (i=0; i < size; i++) {
+    if ((code= codes[i])) {
+      for (scan= qh_HASHslot(qh, code); qh->newhash[scan]; scan= (scan+1) & mask)
+        ;
+      qh->newhash[scan]= code;
+      qh->newhashfacets[scan]= facets[i];
+    }
+  }
+  qh_memfree(qh, codes, size * (int)sizeof(unsigned));
+  qh_memfree(qh, facets, size * (int)sizeof(facetT *));
+} /* growhash */
+
 /*-<a                             href="qh-qhull_r.htm#TOC"
   >-------------------------------</a><a name="infiniteloop">-</a>
 
@@ -1798,10 +1929,16 @@ good point(QGn or QG-n), or a good vertex with 'QJ' or 'Q0' (QVn).\n");
     doubles checks orientation (in case of axis-parallel facets with Gaussian elimination)
     checks for flipped facets and qh.NARROWhull
     checks the result
+
+  notes:
+    with 'QE', the orientation is from qh_exactoutside of the vertex opposite
+    to the first facet, and there is no flipped facet or narrow hull
 */
 void qh_initialhull(qhT *qh, setT *vertices) {
   facetT *facet, *firstfacet, *neighbor, **neighborp;
+  vertexT *vertex, **vertexp;
   realT dist, angle, minangle= REALmax;
+  boolT isflip= False;
 #ifndef qh_NOtrace
   int k;
 #endif
@@ -1813,54 +1950,67 @@ void qh_initialhull(qhT *qh, setT *vertices) {
   firstfacet= qh->facet_list;
   qh_setfacetplane(qh, firstfacet);
   zinc_(Znumvisibility); /* needs to be in printsummary */
-  qh_distplane(qh, qh->interior_point, firstfacet, &dist);
-  if (dist > 0) {
+  if (qh->EXACTpredicates) {
+    FOREACHvertex_(vertices) {
+      if (!qh_setin(firstfacet->vertices, vertex))
+        isflip= qh_exactoutside(qh, vertex->point, firstfacet);
+    }
+  }else {
+    qh_distplane(qh, qh->interior_point, firstfacet, &dist);
+    isflip= (dist > 0);
+  }
+  if (isflip) {
     FORALLfacets
       facet->toporient ^= (unsigned char)True;
   }
   FORALLfacets
     qh_setfacetplane(qh, facet);
-  FORALLfacets {
-    if (!qh_checkflipped(qh, facet, NULL, qh_ALL)) {/* due to axis-parallel facet */
-      trace1((qh, qh->ferr, 1031, "qh_initialhull: initial orientation incorrect.  Correct all facets\n"));
-      facet->flipped= False;
-      FORALLfacets {
-        facet->toporient ^= (unsigned char)True;
-        qh_orientoutside(qh, facet);
+  if (!qh->EXACTpredicates) {  /* the exact simplex is neither flipped nor flat */
+    FORALLfacets {
+      if (!qh_checkflipped(qh, facet, NULL, qh_ALL)) {/* due to axis-parallel facet */
+        trace1((qh, qh->ferr, 1031, "qh_initialhull: initial orientation incorrect.  Correct all facets\n"));
+        facet->flipped= False;
+        FORALLfacets {
+          facet->toporient ^= (unsigned char)True;
+          qh_orientoutside(qh, facet);
+        }
+        break;
       }
-      break;
     }
-  }
-  FORALLfacets {
-    if (!qh_checkflipped(qh, facet, NULL, !qh_ALL)) {  /* can happen with 'R0.1' */
-      if (qh->DELAUNAY && ! qh->ATinfinity) {
-        if (qh->UPPERdelaunay)
-          qh_fprintf(qh, qh->ferr, 6240, "Qhull precision error: Initial simplex is cocircular or cospherical.  Option 'Qs' searches all points.  Can not compute the upper Delaunay triangulation or upper Voronoi diagram of cocircular/cospherical points.\n");
-        else
-          qh_fprintf(qh, qh->ferr, 6239, "Qhull precision error: Initial simplex is cocircular or cospherical.  Use option 'Qz' for the Delaunay triangulation or Voronoi diagram of cocircular/cospherical points.  Option 'Qz' adds a point \"at infinity\".  Use option 'Qs' to search all points for the initial simplex.\n");
-        qh_errexit(qh, qh_ERRinput, NULL, NULL);
+    FORALLfacets {
+      if (!qh_checkflipped(qh, facet, NULL, !qh_ALL)) {  /* can happen with 'R0.1' */
+        if (qh->DELAUNAY && ! qh->ATinfinity) {
+          if (qh->UPPERdelaunay)
+            qh_fprintf(qh, qh->ferr, 6240, "Qhull precision error: Initial simplex is cocircular or cospherical.  Option 'Qs' searches all points.  Can not compute the upper Delaunay triangulation or upper Voronoi diagram of cocircular/cospherical points.\n");
+          else
+            qh_fprintf(qh, qh->ferr, 6239, "Qhull precision error: Initial simplex is cocircular or cospherical.  Use option 'Qz' for the Delaunay triangulation or Voronoi diagram of cocircular/cospherical points.  Option 'Qz' adds a point \"at infinity\".  Use option 'Qs' to search all points for the initial simplex.\n");
+          qh_errexit(qh, qh_ERRinput, NULL, NULL);
+        }
+        qh_precision(qh, "initial simplex is flat");
+        qh_fprintf(qh, qh->ferr, 6154, "Qhull precision error: Initial simplex is flat (facet %d is coplanar with the interior point)\n",
+                     facet->id);
+        qh_errexit(qh, qh_ERRsingular, NULL, NULL);  /* calls qh_printhelp_singular */
+      }
+      FOREACHneighbor_(facet) {
+        angle= qh_getangle(qh, facet->normal, neighbor->normal);
+        minimize_( minangle, angle);
       }
-      qh_precision(qh, "initial simplex is flat");
-      qh_fprintf(qh, qh->ferr, 6154, "Qhull precision error: Initial simplex is flat (facet %d is coplanar with the interior point)\n",
-                   facet->id);
-      qh_errexit(qh, qh_ERRsingular, NULL, NULL);  /* calls qh_printhelp_singular */
-    }
-    FOREACHneighbor_(facet) {
-      angle= qh_getangle(qh, facet->normal, neighbor->normal);
-      minimize_( minangle, angle);
     }
-  }
-  if (minangle < qh_MAXnarrow && !qh->NOnarrow) {
-    realT diff= 1.0 + minangle;
+    if (minangle < qh_MAXnarrow && !qh->NOnarrow) {
+      realT diff= 1.0 + minangle;
 
-    qh->NARROWhull= True;
-    qh_option(qh, "_narrow-hull", NULL, &diff);
-    if (minangle < qh_WARNnarrow && !qh->RERUN && qh->PRINTprecision)
-      qh_printhelp_narrowhull(qh, qh->ferr, minangle);
+      qh->NARROWhull= True;
+      qh_option(qh, "_narrow-hull", NULL, &diff);
+      if (minangle < qh_WARNnarrow && !qh->RERUN && qh->PRINTprecision)
+        qh_printhelp_narrowhull(qh, qh->ferr, minangle);
+    }
   }
   zzval_(Zprocessed)= qh->hull_dim+1;
   qh_checkpolygon(qh, qh->facet_list);
-  qh_checkconvex(qh, qh->facet_list,   qh_DATAfault);
+  if (qh->EXACTpredicates)
+    qh_checkexact(qh, qh->facet_list);
+  else
+    qh_checkconvex(qh, qh->facet_list,   qh_DATAfault);
 #ifndef qh_NOtrace
   if (qh->IStracing >= 1) {
     qh_fprintf(qh, qh->ferr, 8105, "qh_initialhull: simplex constructed, interior point:");
@@ -2058,8 +2208,8 @@ vertexT *qh_makenewfacets(qhT *qh, pointT *point /*visible_list*/) {
 /*-<a                             href="qh-poly_r.htm#TOC"
   >-------------------------------</a><a name="matchduplicates">-</a>
 
-  qh_matchduplicates(qh, atfacet, atskip, hashsize, hashcount )
-    match duplicate ridges in qh.hash_table for atfacet/atskip
+  qh_matchduplicates(qh, atfacet, atskip, hashcount )
+    match duplicate ridges in qh.newhash for atfacet/atskip
     duplicates marked with ->dupridge and qh_DUPLICATEridge
 
   returns:
@@ -2074,7 +2224,7 @@ vertexT *qh_makenewfacets(qhT *qh, pointT *point /*visible_list*/) {
   design:
     compute hash value for atfacet and atskip
     repeat twice -- once to make best matches, once to match the rest
-      for each possible facet in qh.hash_table
+      for each possible facet in qh.newhash with the same hash code
         if it is a matching facet and pass 2
           make match
           unless tricoplanar, mark match for merging (qh_MERGEridge)
@@ -2085,15 +2235,17 @@ vertexT *qh_makenewfacets(qhT *qh, pointT *point /*visible_list*/) {
         make best match (it will not be merged)
 */
 #ifndef qh_NOmerge
-void qh_matchduplicates(qhT *qh, facetT *atfacet, int atskip, int hashsize, int *hashcount) {
+void qh_matchduplicates(qhT *qh, facetT *atfacet, int atskip, int *hashcount) {
   boolT same, ismatch;
-  int hash, scan;
+  unsigned code;
+  int hash, scan, mask= qh->newhashsize - 1;
   facetT *facet, *newfacet, *maxmatch= NULL, *maxmatch2= NULL, *nextfacet;
   int skip, newskip, nextskip= 0, maxskip= 0, maxskip2= 0, makematch;
   realT maxdist= -REALmax, mindist, dist2, low, high;
 
-  hash= qh_gethash(qh, hashsize, atfacet->vertices, qh->hull_dim, 1,
-                     SETelem_(atfacet->vertices, atskip));
+  code= qh_gethashcode(qh, atfacet->vertices, qh->hull_dim, 1,
+                     SETelem_(atfacet->vertices, atskip)) | 1;  /* as in qh_matchneighbor */
+  hash= qh_HASHslot(qh, code);
   trace2((qh, qh->ferr, 2046, "qh_matchduplicates: find duplicate matches for f%d skip %d hash %d hashcount %d\n",
           atfacet->id, atskip, hash, *hashcount));
   for (makematch= 0; makematch < 2; makematch++) {
@@ -2102,8 +2254,10 @@ void qh_matchduplicates(qhT *qh, facetT *atfacet, int atskip, int hashsize, int
       zinc_(Zhashlookup);
       nextfacet= NULL;
       newfacet->visitid= qh->visit_id;
-      for (scan= hash; (facet= SETelemt_(qh->hash_table, scan, facetT));
-           scan= (++scan >= hashsize ? 0 : scan)) {
+      for (scan= hash; qh->newhash[scan]; scan= (scan+1) & mask) {
+        if (qh->newhash[scan] != code)
+          continue;
+        facet= qh->newhashfacets[scan];
         if (!facet->dupridge || facet->visitid == qh->visit_id)
           continue;
         zinc_(Zhashtests);
@@ -2290,6 +2444,39 @@ vertexT *qh_nearvertex(qhT *qh, facetT *facet, pointT *point, realT *bestdistp)
   return bestvertex;
 } /* nearvertex */
 
+/*-<a                             href="qh-poly_r.htm#TOC"
+  >-------------------------------</a><a name="newhash">-</a>
+
+  qh_newhash(qh, newsize )
+    allocate qh.newhash for newsize entries, with at least
+    newsize*qh_HASHfactor empty entries
+
+  notes:
+    assumes qh.newhash is NULL
+    the size is a power of 2 for qh_HASHslot
+    the probes read the array of hash codes (4 bytes per entry), and the
+      facet of an entry only if its code is the one searched
+    qh_addnewhash grows the table past 3/4 full (qh_growhash)
+*/
+void qh_newhash(qhT *qh, int newsize) {
+  int size= 2, shift= 31;
+
+  if (newsize < 0 || newsize > INT_MAX/(qh_HASHfactor * 2 * (int)sizeof(facetT *))) {
+    qh_fprintf(qh, qh->qhmem.ferr, 6430, "qhull error (qh_newhash): negative request or overflow (%d).  Did int overflow due to high-D?\n", newsize); /* WARN64 */
+    qh_errexit(qh, qhmem_ERRmem, NULL, NULL);
+  }
+  while (size < (newsize+1)*qh_HASHfactor) {
+    size *= 2;
+    shift--;
+  }
+  qh->newhash= (unsigned *)qh_memalloc(qh, size * (int)sizeof(unsigned));
+  qh->newhashfacets= (facetT **)qh_memalloc(qh, size * (int)sizeof(facetT *));
+  memset((char *)qh->newhash, 0, (size_t)size * sizeof(unsigned));
+  qh->newhashsize= size;
+  qh->newhashshift= shift;
+  qh->newhashcount= 0;
+} /* newhash */
+
 /*-<a                             href="qh-poly_r.htm#TOC"
   >-------------------------------</a><a name="newhashtable">-</a>
 
@@ -2392,7 +2579,7 @@ ridgeT *qh_nextridge3d(ridgeT *atridge, facetT *facet, vertexT **vertexp) {
   return NULL;
 } /* nextridge3d */
 #else /* qh_NOmerge */
-void qh_matchduplicates(qhT *qh, facetT *atfacet, int atskip, int hashsize, int *hashcount) {
+void qh_matchduplicates(qhT *qh, facetT *atfacet, int atskip, int *hashcount) {
 }
 ridgeT *qh_nextridge3d(ridgeT *atridge, facetT *facet, vertexT **vertexp) {
 
@@ -2612,11 +2799,12 @@ void qh_prependfacet(qhT *qh, facetT *facet, facetT **facetlist) {
 */
 void qh_printhashtable(qhT *qh, FILE *fp) {
   facetT *facet, *neighbor;
-  int id, facet_i, facet_n, neighbor_i= 0, neighbor_n= 0;
+  int id, facet_i, neighbor_i= 0, neighbor_n= 0;
   vertexT *vertex, **vertexp;
 
-  FOREACHfacet_i_(qh, qh->hash_table) {
-    if (facet) {
+  for (facet_i=0; facet_i < qh->newhashsize; facet_i++) {
+    if (qh->newhash[facet_i]) {
+      facet= qh->newhashfacets[facet_i];
       FOREACHneighbor_i_(qh, facet) {
         if (!neighbor || neighbor == qh_MERGEridge || neighbor == qh_DUPLICATEridge)
           break;
@@ -2779,6 +2967,7 @@ void qh_triangulate(qhT *qh /*qh.facet_list*/) {
   trace1((qh, qh->ferr, 1034, "qh_triangulate: triangulate non-simplicial facets\n"));
   if (qh->hull_dim == 2)
     return;
+  TRACE_BEGIN("qh_triangulate");
   if (qh->VORONOI) {  /* otherwise lose Voronoi centers [could rebuild vertex set from tricoplanar] */
     qh_clearcenters(qh, qh_ASvoronoi);
     qh_vertexneighbors(qh);
@@ -2796,6 +2985,8 @@ void qh_triangulate(qhT *qh /*qh.facet_list*/) {
     if (!new_facet_list)
       new_facet_list= facet;  /* will be moved to end */
     qh_triangulate_facet(qh, facet, &new_vertex_list);
+    if (qh->progress_fn && (*qh->progress_fn)(qh))
+      qh_errcancel(qh);
   }
   trace2((qh, qh->ferr, 2047, "qh_triangulate: delete null facets from f%d -- apex same as second vertex\n", getid_(new_facet_list)));
   for (facet= new_facet_list; facet && facet->next; facet= nextfacet) { /* null facets moved to end */
@@ -2913,6 +3104,7 @@ void qh_triangulate(qhT *qh /*qh.facet_list*/) {
   if (qh->CHECKfrequently)
     qh_checkpolygon(qh, qh->facet_list);
   qh->hasTriangulation= True;
+  TRACE_END("qh_triangulate");
 } /* triangulate */
 
 
@@ -2938,6 +3130,7 @@ void qh_triangulate(qhT *qh /*qh.facet_list*/) {
         if qh.TRInormals and qh_AScentrum, newfacet->center will need qh_free
         keepcentrum is also set on Zwidefacet in qh_mergefacet
         freed by qh_clearcenters
+      if qh_LEANfacets, an inline facetA->normal is copied before it is shared
 
   see also:
       qh_addpoint() -- add a point
@@ -2969,6 +3162,13 @@ void qh_triangulate_facet(qhT *qh, facetT *facetA, vertexT **first_vertex) {
         && fabs_(facetA->normal[qh->hull_dim -1]) >= qh->ANGLEround * qh_ZEROdelaunay) {
     facetA->center= qh_facetcenter(qh, facetA->vertices);
   }
+#if qh_LEANfacets
+  if (!qh->TRInormals && facetA->normal == qh_INLINEnormal_(qh, facetA)) { /* shared by the tricoplanar facets, it outlives facetA */
+    coordT *normal= (coordT *)qh_memalloc(qh, qh->normal_size);
+    memcpy((char *)normal, facetA->normal, (size_t)qh->normal_size);
+    facetA->normal= normal;
+  }
+#endif
   qh_willdelete(qh, facetA, NULL);
   qh->newfacet_list= qh->facet_tail;
   facetA->visitid= qh->visit_id;
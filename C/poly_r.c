@@ -254,6 +254,9 @@ void qh_delfacet(qhT *qh, facetT *facet) {
     qh->GOODclosest= NULL;
   qh_removefacet(qh, facet);
   if (!facet->tricoplanar || facet->keepcentrum) {
+#if qh_LEANfacets
+    if (facet->normal != qh_INLINEnormal_(qh, facet))
+#endif
     qh_memfree_(qh, facet->normal, qh->normal_size, freelistp);
     if (qh->CENTERtype == qh_ASvoronoi) {   /* braces for macro calls */
       qh_memfree_(qh, facet->center, qh->center_size, freelistp);
@@ -269,7 +272,7 @@ void qh_delfacet(qhT *qh, facetT *facet) {
     qh_setfree(qh, &(facet->outsideset));
   if (facet->coplanarset)
     qh_setfree(qh, &(facet->coplanarset));
-  qh_memfree_(qh, facet, (int)sizeof(facetT), freelistp);
+  qh_memfree_(qh, facet, qh->facet_size, freelistp);
 } /* delfacet */
 
 
@@ -403,15 +406,40 @@ setT *qh_facetintersect(qhT *qh, facetT *facetA, facetT *facetB,
     using sum for hash does badly in high d
 */
 int qh_gethash(qhT *qh, int hashsize, setT *set, int size, int firstindex, void *skipelem) {
+  unsigned result;
+
+  if (hashsize<0) {
+    qh_fprintf(qh, qh->ferr, 6202, "qhull internal error: negative hashsize %d passed to qh_gethash [poly.c]\n", hashsize);
+    qh_errexit2(qh, qh_ERRqhull, NULL, NULL);
+  }
+  result= qh_gethashcode(qh, set, size, firstindex, skipelem);
+  result %= (unsigned)hashsize;
+  /* result= 0; for debugging */
+  return result;
+} /* gethash */
+
+/*-<a                             href="qh-poly_r.htm#TOC"
+  >-------------------------------</a><a name="gethashcode">-</a>
+
+  qh_gethashcode(qh, set, size, firstindex, skipelem )
+    return the hash code of a set with firstindex and skipelem
+
+  notes:
+    qh_gethash is the code modulo its hashsize
+    assumes at least firstindex+1 elements
+    assumes skipelem is NULL, in set, or part of hash
+*/
+unsigned qh_gethashcode(qhT *qh, setT *set, int size, int firstindex, void *skipelem) {
   void **elemp= SETelemaddr_(set, firstindex, void);
   ptr_intT hash = 0, elem;
-  unsigned result;
   int i;
 #ifdef _MSC_VER                   /* Microsoft Visual C++ -- warn about 64-bit issues */
 #pragma warning( push)            /* WARN64 -- ptr_intT holds a 64-bit pointer */
 #pragma warning( disable : 4311)  /* 'type cast': pointer truncation from 'void*' to 'ptr_intT' */
 #endif
 
+  QHULL_UNUSED(qh)
+
   switch (size-firstindex) {
   case 1:
     hash= (ptr_intT)(*elemp) - (ptr_intT) skipelem;
@@ -449,18 +477,11 @@ int qh_gethash(qhT *qh, int hashsize, setT *set, int size, int firstindex, void
     }while (*elemp);
     break;
   }
-  if (hashsize<0) {
-    qh_fprintf(qh, qh->ferr, 6202, "qhull internal error: negative hashsize %d passed to qh_gethash [poly.c]\n", hashsize);
-    qh_errexit2(qh, qh_ERRqhull, NULL, NULL);
-  }
-  result= (unsigned)hash;
-  result %= (unsigned)hashsize;
-  /* result= 0; for debugging */
-  return result;
+  return (unsigned)hash;
 #ifdef _MSC_VER
 #pragma warning( pop)
 #endif
-} /* gethash */
+} /* gethashcode */
 
 /*-<a                             href="qh-poly_r.htm#TOC"
   >-------------------------------</a><a name="makenewfacet">-</a>
@@ -471,10 +492,13 @@ int qh_gethash(qhT *qh, int hashsize, setT *set, int size, int firstindex, void
   returns:
     returns newfacet
       adds newfacet to qh.facet_list
-      newfacet->vertices= vertices
+      newfacet->vertices= vertices, or a copy in its inline set
       if horizon
         newfacet->neighbor= horizon, but not vice versa
     newvertex_list updated with vertices
+
+  notes:
+    frees vertices if copied (at most hull_dim vertices)
 */
 facetT *qh_makenewfacet(qhT *qh, setT *vertices, boolT toporient,facetT *horizon) {
   facetT *newfacet;
@@ -487,7 +511,7 @@ facetT *qh_makenewfacet(qhT *qh, setT *vertices, boolT toporient,facetT *horizon
     }
   }
   newfacet= qh_newfacet(qh);
-  newfacet->vertices= vertices;
+  newfacet->vertices= qh_newfacetvertices(qh, newfacet, vertices);
   newfacet->toporient= (unsigned char)toporient;
   if (horizon)
     qh_setappend(qh, &(newfacet->neighbors), horizon);
@@ -693,22 +717,23 @@ facetT *qh_makenew_simplicial(qhT *qh, facetT *visible, vertexT *apex, int *numn
 /*-<a                             href="qh-poly_r.htm#TOC"
   >-------------------------------</a><a name="matchneighbor">-</a>
 
-  qh_matchneighbor(qh, newfacet, newskip, hashsize, hashcount )
-    either match subridge of newfacet with neighbor or add to hash_table
+  qh_matchneighbor(qh, newfacet, newskip, hashcount )
+    either match subridge of newfacet with neighbor or add to qh.newhash
 
   returns:
     duplicate ridges are unmatched and marked by qh_DUPLICATEridge
 
   notes:
     ridge is newfacet->vertices w/o newskip vertex
-    do not allocate memory (need to free hash_table cleanly)
-    uses linear hash chains
+    qh_growhash may reallocate qh.newhash after an insertion
+    uses linear hash chains, and skips the entries of other hash codes
+    newfacet is in the chain once per hash code
 
   see also:
     qh_matchduplicates
 
   design:
-    for each possible matching facet in qh.hash_table
+    for each possible matching facet in qh.newhash with the same hash code
       if vertices match
         set ismatch, if facets have opposite orientation
         if ismatch and matching facet doesn't have a match
@@ -721,20 +746,24 @@ facetT *qh_makenew_simplicial(qhT *qh, facetT *visible, vertexT *apex, int *numn
             mark both facets with a duplicate ridge
             add other facet (if defined) to hash table
 */
-void qh_matchneighbor(qhT *qh, facetT *newfacet, int newskip, int hashsize, int *hashcount) {
+void qh_matchneighbor(qhT *qh, facetT *newfacet, int newskip, int *hashcount) {
   boolT newfound= False;   /* True, if new facet is already in hash chain */
   boolT same, ismatch;
-  int hash, scan;
+  unsigned code;
+  int hash, scan, mask= qh->newhashsize - 1;
   facetT *facet, *matchfacet;
   int skip, matchskip;
 
-  hash= qh_gethash(qh, hashsize, newfacet->vertices, qh->hull_dim, 1,
-                     SETelem_(newfacet->vertices, newskip));
+  code= qh_gethashcode(qh, newfacet->vertices, qh->hull_dim, 1,
+                     SETelem_(newfacet->vertices, newskip)) | 1;  /* 0 is an empty entry */
+  hash= qh_HASHslot(qh, code);
   trace4((qh, qh->ferr, 4050, "qh_matchneighbor: newfacet f%d skip %d hash %d hashcount %d\n",
           newfacet->id, newskip, hash, *hashcount));
   zinc_(Zhashlookup);
-  for (scan= hash; (facet= SETelemt_(qh->hash_table, scan, facetT));
-       scan= (++scan >= hashsize ? 0 : scan)) {
+  for (scan= hash; qh->newhash[scan]; scan= (scan+1) & mask) {
+    if (qh->newhash[scan] != code)
+      continue;
+    facet= qh->newhashfacets[scan];
     if (facet == newfacet) {
       newfound= True;
       continue;
@@ -768,7 +797,7 @@ void qh_matchneighbor(qhT *qh, facetT *newfacet, int newskip, int hashsize, int
       newfacet->dupridge= True;
       if (!newfacet->normal)
         qh_setfacetplane(qh, newfacet);
-      qh_addhash(newfacet, qh->hash_table, hashsize, hash);
+      qh_addnewhash(qh, newfacet, code);
       (*hashcount)++;
       if (!facet->normal)
         qh_setfacetplane(qh, facet);
@@ -788,7 +817,7 @@ void qh_matchneighbor(qhT *qh, facetT *newfacet, int newskip, int hashsize, int
           matchfacet->dupridge= True;
           if (!matchfacet->normal)
             qh_setfacetplane(qh, matchfacet);
-          qh_addhash(matchfacet, qh->hash_table, hashsize, hash);
+          qh_addnewhash(qh, matchfacet, code);
           *hashcount += 2;
         }
       }
@@ -799,8 +828,12 @@ void qh_matchneighbor(qhT *qh, facetT *newfacet, int newskip, int hashsize, int
       return; /* end of duplicate ridge */
     }
   }
-  if (!newfound)
-    SETelem_(qh->hash_table, scan)= newfacet;  /* same as qh_addhash */
+  if (!newfound) {  /* same as qh_addnewhash */
+    qh->newhash[scan]= code;
+    qh->newhashfacets[scan]= newfacet;
+    if (++qh->newhashcount > qh->newhashsize/4*3)
+      qh_growhash(qh);
+  }
   (*hashcount)++;
   trace4((qh, qh->ferr, 4053, "qh_matchneighbor: no match for f%d skip %d at hash %d\n",
            newfacet->id, newskip, hash));
@@ -824,13 +857,13 @@ void qh_matchneighbor(qhT *qh, facetT *newfacet, int newskip, int hashsize, int
 
   notes:
     newfacets already have neighbor[0] (horizon facet)
-    assumes qh.hash_table is NULL
+    assumes qh.newhash is NULL
     vertex->neighbors has not been updated yet
-    do not allocate memory after qh.hash_table (need to free it cleanly)
+    do not allocate memory after qh.newhash (need to free it cleanly)
 
   design:
     delete neighbor sets for all new facets
-    initialize a hash table
+    initialize a hash table (qh.newhash)
     for all new facets
       match facet with neighbors
     if unmatched facets (due to duplicate ridges)
@@ -841,11 +874,10 @@ void qh_matchneighbor(qhT *qh, facetT *newfacet, int newskip, int hashsize, int
 void qh_matchnewfacets(qhT *qh /* qh.newfacet_list */) {
   int numnew=0, hashcount=0, newskip;
   facetT *newfacet, *neighbor;
-  int dim= qh->hull_dim, hashsize, neighbor_i, neighbor_n;
+  int dim= qh->hull_dim, neighbor_i, neighbor_n;
   setT *neighbors;
 #ifndef qh_NOtrace
-  int facet_i, facet_n, numfree= 0;
-  facetT *facet;
+  int i, numfree= 0;
 #endif
 
   trace1((qh, qh->ferr, 1019, "qh_matchnewfacets: match neighbors for new facets.\n"));
@@ -858,13 +890,11 @@ void qh_matchnewfacets(qhT *qh /* qh.newfacet_list */) {
     }
   }
 
-  qh_newhashtable(qh, numnew*(qh->hull_dim-1)); /* twice what is normally needed,
-                                     but every ridge could be DUPLICATEridge */
-  hashsize= qh_setsize(qh, qh->hash_table);
+  qh_newhash(qh, numnew*(qh->hull_dim-1)/2); /* each ridge is normally added once,
+                                     qh_growhash for DUPLICATEridge */
   FORALLnew_facets {
     for (newskip=1; newskip<qh->hull_dim; newskip++) /* furthest/horizon already matched */
-      /* hashsize>0 because hull_dim>1 and numnew>0 */
-      qh_matchneighbor(qh, newfacet, newskip, hashsize, &hashcount);
+      qh_matchneighbor(qh, newfacet, newskip, &hashcount);
 #if 0   /* use the following to trap hashcount errors */
     {
       int count= 0, k;
@@ -893,7 +923,7 @@ void qh_matchnewfacets(qhT *qh /* qh.newfacet_list */) {
       if (newfacet->dupridge) {
         FOREACHneighbor_i_(qh, newfacet) {
           if (neighbor == qh_DUPLICATEridge) {
-            qh_matchduplicates(qh, newfacet, neighbor_i, hashsize, &hashcount);
+            qh_matchduplicates(qh, newfacet, neighbor_i, &hashcount);
                     /* this may report MERGEfacet */
           }
         }
@@ -908,15 +938,15 @@ void qh_matchnewfacets(qhT *qh /* qh.newfacet_list */) {
   }
 #ifndef qh_NOtrace
   if (qh->IStracing >= 2) {
-    FOREACHfacet_i_(qh, qh->hash_table) {
-      if (!facet)
+    for (i=0; i < qh->newhashsize; i++) {
+      if (!qh->newhash[i])
         numfree++;
     }
     qh_fprintf(qh, qh->ferr, 8089, "qh_matchnewfacets: %d new facets, %d unused hash entries .  hashsize %d\n",
-             numnew, numfree, qh_setsize(qh, qh->hash_table));
+             numnew, numfree, qh->newhashsize);
   }
 #endif /* !qh_NOtrace */
-  qh_setfree(qh, &qh->hash_table);
+  qh_freenewhash(qh);
   if (qh->PREmerge || qh->MERGEexact) {
     if (qh->IStracing >= 4)
       qh_printfacetlist(qh, qh->newfacet_list, NULL, qh_ALL);
@@ -981,17 +1011,26 @@ boolT qh_matchvertices(qhT *qh, int firstindex, setT *verticesA, int skipA,
   returns:
     all fields initialized or cleared   (NULL)
     preallocates neighbors set
+
+  notes:
+    one allocation of qh.facet_size for the facet, and the storage of two
+      inline sets of hull_dim elements (qh_setinline)
+    the first is facet->neighbors, the second is for facet->vertices
+      (qh_makenewfacet, qh_createsimplex).  A simplicial facet keeps both
+    if 'QE', followed by the cofactors of qh_exactplane (qh_EXACTplane_)
+    if qh_LEANfacets, followed by the storage of facet->normal (qh_INLINEnormal_)
+    a set that grows past hull_dim is copied to the heap by qset_r.c
 */
 facetT *qh_newfacet(qhT *qh) {
   facetT *facet;
   void **freelistp; /* used if !qh_NOmem by qh_memalloc_() */
 
-  qh_memalloc_(qh, (int)sizeof(facetT), freelistp, facet, facetT);
+  qh_memalloc_(qh, qh->facet_size, freelistp, facet, facetT);
   memset((char *)facet, (size_t)0, sizeof(facetT));
   if (qh->facet_id == qh->tracefacet_id)
     qh->tracefacet= facet;
   facet->id= qh->facet_id++;
-  facet->neighbors= qh_setnew(qh, qh->hull_dim);
+  facet->neighbors= qh_setinline((char *)facet + sizeof(facetT), qh->hull_dim);
 #if !qh_COMPUTEfurthest
   facet->furthestdist= 0.0;
 #endif
@@ -1008,6 +1047,31 @@ facetT *qh_newfacet(qhT *qh) {
   return(facet);
 } /* newfacet */
 
+/*-<a                             href="qh-poly_r.htm#TOC"
+  >-------------------------------</a><a name="newfacetvertices">-</a>
+
+  qh_newfacetvertices(qh, newfacet, vertices )
+    return the vertex set for newfacet from qh_newfacet
+
+  returns:
+    vertices unchanged if it has more than hull_dim elements
+    otherwise a copy of vertices in the inline set of newfacet (vertices is freed)
+
+  notes:
+    the vertices of a simplicial facet are next to the facet in memory,
+      and freed with it
+*/
+setT *qh_newfacetvertices(qhT *qh, facetT *newfacet, setT *vertices) {
+  setT *set;
+
+  if (qh_setsize(qh, vertices) > qh->hull_dim)
+    return vertices;
+  set= qh_setinline((char *)newfacet + sizeof(facetT) + SETinlinesize_(qh->hull_dim), qh->hull_dim);
+  qh_setappend_set(qh, &set, vertices);
+  qh_setfree(qh, &vertices);
+  return set;
+} /* newfacetvertices */
+
 
 /*-<a                             href="qh-poly_r.htm#TOC"
   >-------------------------------</a><a name="newridge">-</a>
@@ -61,6 +61,29 @@
 
 /*=========== -macros- =========================*/
 
+/*-<a                             href="qh-poly_r.htm#TOC"
+  >--------------------------------</a><a name="HASHslot">-</a>
+
+  qh_HASHslot( qh, code )
+    return the first entry of qh.newhash for a ridge with this code
+
+  notes:
+    multiplicative hashing: the high bits of code times 2^32/golden ratio
+    the entries of a code are at qh_HASHslot or after (linear probing)
+*/
+#define qh_HASHslot(qh, code) ((int)((unsigned)((code) * 2654435769U) >> (qh)->newhashshift))
+
+/*-<a                             href="qh-poly_r.htm#TOC"
+  >--------------------------------</a><a name="INLINEnormal_">-</a>
+
+  qh_INLINEnormal_( qh, facet )
+    return the storage for facet->normal at the end of a facet from qh_newfacet
+
+  notes:
+    only if qh_LEANfacets.  qh_delfacet does not free it
+*/
+#define qh_INLINEnormal_(qh, facet) ((coordT *)((char *)(facet) + (qh)->facet_size - (qh)->normal_size))
+
 /*-<a                             href="qh-poly_r.htm#TOC"
   >--------------------------------</a><a name="FORALLfacet_">-</a>
 
@@ -219,16 +242,17 @@ void    qh_delfacet(qhT *qh, facetT *facet);
 void    qh_deletevisible(qhT *qh /* qh.visible_list, qh.horizon_list */);
 setT   *qh_facetintersect(qhT *qh, facetT *facetA, facetT *facetB, int *skipAp,int *skipBp, int extra);
 int     qh_gethash(qhT *qh, int hashsize, setT *set, int size, int firstindex, void *skipelem);
+unsigned qh_gethashcode(qhT *qh, setT *set, int size, int firstindex, void *skipelem);
 facetT *qh_makenewfacet(qhT *qh, setT *vertices, boolT toporient, facetT *facet);
 void    qh_makenewplanes(qhT *qh /* qh.newfacet_list */);
 facetT *qh_makenew_nonsimplicial(qhT *qh, facetT *visible, vertexT *apex, int *numnew);
 facetT *qh_makenew_simplicial(qhT *qh, facetT *visible, vertexT *apex, int *numnew);
-void    qh_matchneighbor(qhT *qh, facetT *newfacet, int newskip, int hashsize,
-                          int *hashcount);
+void    qh_matchneighbor(qhT *qh, facetT *newfacet, int newskip, int *hashcount);
 void    qh_matchnewfacets(qhT *qh);
 boolT   qh_matchvertices(qhT *qh, int firstindex, setT *verticesA, int skipA,
                           setT *verticesB, int *skipB, boolT *same);
 facetT *qh_newfacet(qhT *qh);
+setT   *qh_newfacetvertices(qhT *qh, facetT *newfacet, setT *vertices);
 ridgeT *qh_newridge(qhT *qh);
 int     qh_pointid(qhT *qh, pointT *point);
 void    qh_removefacet(qhT *qh, facetT *facet);
@@ -239,6 +263,7 @@ void    qh_updatevertices(qhT *qh);
 /*========== -prototypes poly2_r.c in alphabetical order ===========*/
 
 void    qh_addhash(void *newelem, setT *hashtable, int hashsize, int hash);
+void    qh_addnewhash(qhT *qh, facetT *facet, unsigned code);
 void    qh_check_bestdist(qhT *qh);
 void    qh_check_dupridge(qhT *qh, facetT *facet1, realT dist1, facetT *facet2, realT dist2);
 void    qh_check_maxout(qhT *qh);
@@ -246,6 +271,7 @@ void    qh_check_output(qhT *qh);
 void    qh_check_point(qhT *qh, pointT *point, facetT *facet, realT *maxoutside, realT *maxdist, facetT **errfacet1, facetT **errfacet2);
 void    qh_check_points(qhT *qh);
 void    qh_checkconvex(qhT *qh, facetT *facetlist, int fault);
+void    qh_checkexact(qhT *qh, facetT *facetlist);
 void    qh_checkfacet(qhT *qh, facetT *facet, boolT newmerge, boolT *waserrorp);
 void    qh_checkflipped_all(qhT *qh, facetT *facetlist);
 void    qh_checkpolygon(qhT *qh, facetT *facetlist);
@@ -262,17 +288,20 @@ facetT *qh_findfacet_all(qhT *qh, pointT *point, realT *bestdist, boolT *isoutsi
                           int *numpart);
 int     qh_findgood(qhT *qh, facetT *facetlist, int goodhorizon);
 void    qh_findgood_all(qhT *qh, facetT *facetlist);
+void    qh_freenewhash(qhT *qh);
 void    qh_furthestnext(qhT *qh /* qh.facet_list */);
 void    qh_furthestout(qhT *qh, facetT *facet);
+void    qh_growhash(qhT *qh);
 void    qh_infiniteloop(qhT *qh, facetT *facet);
 void    qh_initbuild(qhT *qh);
 void    qh_initialhull(qhT *qh, setT *vertices);
 setT   *qh_initialvertices(qhT *qh, int dim, setT *maxpoints, pointT *points, int numpoints);
 vertexT *qh_isvertex(pointT *point, setT *vertices);
 vertexT *qh_makenewfacets(qhT *qh, pointT *point /*horizon_list, visible_list*/);
-void    qh_matchduplicates(qhT *qh, facetT *atfacet, int atskip, int hashsize, int *hashcount);
+void    qh_matchduplicates(qhT *qh, facetT *atfacet, int atskip, int *hashcount);
 void    qh_nearcoplanar(qhT *qh /* qh.facet_list */);
 vertexT *qh_nearvertex(qhT *qh, facetT *facet, pointT *point, realT *bestdistp);
+void    qh_newhash(qhT *qh, int newsize);
 int     qh_newhashtable(qhT *qh, int newsize);
 vertexT *qh_newvertex(qhT *qh, pointT *point);
 ridgeT *qh_nextridge3d(ridgeT *atridge, facetT *facet, vertexT **vertexp);
@@ -0,0 +1,746 @@
+/*<html><pre>  -<a                             href="qh-geom_r.htm"
+  >-------------------------------</a><a name="TOP">-</a>
+
+
+   predicates_r.c
+   exact predicates of qhull for option 'QE'
+
+   see qh-geom_r.htm and geom_r.h
+
+   With 'QE', qhull decides whether a point is above a facet from the
+   coordinates of the point and of the vertices of the facet, instead of the
+   distance to the hyperplane of the facet.  The sign is that of the
+   determinant of the homogeneous coordinates of the points.  It is computed
+   - with floating-point arithmetic and an error bound (the filter), from
+     the cofactors stored with the facet by qh_exactplane
+   - otherwise with the exact arithmetic of expansions, as in
+     J.R. Shewchuk, "Adaptive precision floating-point arithmetic and fast
+     robust geometric predicates", Discrete Comput. Geom. 18:305-363, 1997
+   - if the determinant is zero, by a symbolic perturbation of the
+     coordinates (Simulation of Simplicity, as in H. Edelsbrunner and
+     E.P. Muecke, ACM Trans. Graphics 9:66-104, 1990)
+   So no point is coplanar with a facet, qhull never merges facets, and all
+   the facets are simplicial.
+
+   The predicates are exact for the coordinates of the points as stored by
+   qhull, e.g., after the lifting of 'd' and the scaling of 'Qbb'.
+*/
+
+#include "qhull_ra.h"
+
+#include <float.h>
+#include <math.h>
+
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF   /* the error-free transformations need exact roundings */
+#endif
+
+/*============ -expansions- ================================================
+
+  An expansion is an array of doubles, nonoverlapping and in increasing order
+  of magnitude, whose exact sum is the value.  Zero components are removed,
+  the value 0 is the empty expansion.
+*/
+
+#define qh_TWOsum_(a, b, x, y) { double bv_, av_; \
+  (x)= (a) + (b); bv_= (x) - (a); av_= (x) - bv_; (y)= ((a) - av_) + ((b) - bv_); }
+
+#define qh_FASTtwosum_(a, b, x, y) { double bv_; \
+  (x)= (a) + (b); bv_= (x) - (a); (y)= (b) - bv_; }
+
+#ifdef FP_FAST_FMA
+#define qh_TWOproduct_(a, b, x, y) { (x)= (a) * (b); (y)= fma((a), (b), -(x)); }
+#else
+#define qh_SPLITTER 134217729.0     /* 2^27+1, for Dekker's product */
+#define qh_SPLIT_(a, ahi, alo) { double c_, abig_; \
+  c_= qh_SPLITTER * (a); abig_= c_ - (a); (ahi)= c_ - abig_; (alo)= (a) - (ahi); }
+#define qh_TWOproduct_(a, b, x, y) { double ahi_, alo_, bhi_, blo_, e1_, e2_, e3_; \
+  (x)= (a) * (b); qh_SPLIT_(a, ahi_, alo_); qh_SPLIT_(b, bhi_, blo_); \
+  e1_= (x) - ahi_ * bhi_; e2_= e1_ - alo_ * bhi_; e3_= e2_ - ahi_ * blo_; \
+  (y)= alo_ * blo_ - e3_; }
+#endif
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="DETerr">-</a>
+
+  qh_DETerr_(k)
+    number of roundings of the k-by-k determinant of qh_detlevels,
+    including its permanent
+    add k if the entries are rounded differences
+*/
+#define qh_DETerr_(k) ((k) * ((k) + 1) / 2)
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="SOSmax">-</a>
+
+  qh_SOSmax
+    max. number of perturbed entries, for a determinant of size qh_EXACTdim+1
+*/
+#define qh_SOSmax ((qh_EXACTdim + 1) * qh_EXACTdim)
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="EXPstack">-</a>
+
+  qh_EXPstack
+    size of the expansions of qh_exactdet on the stack, before qh_expgrow
+*/
+#define qh_EXPstack 128
+
+typedef struct {
+  qhT     *qh;
+  pointT  *rows[qh_EXACTdim + 1];  /* by increasing point id */
+  int      dim;                   /* perturbed columns 0..dim-1, dim is the column of 1's */
+  int      numentries;
+  int      required[qh_EXACTdim];  /* index of the first entry of a constant column, or -1 */
+  int      entryrow[qh_SOSmax];    /* the perturbed entries from most to least significant */
+  int      entrycol[qh_SOSmax];
+  int      size;                  /* the entries of the current term */
+  int      termrow[qh_EXACTdim];
+  int      termcol[qh_EXACTdim];
+  boolT    rowused[qh_EXACTdim + 1];
+  boolT    colused[qh_EXACTdim + 1];
+} qh_sosT;
+
+static int qh_expsum(int elen, const double *e, int flen, const double *f, double *h);
+static int qh_expscale(int elen, const double *e, double b, double *h);
+static int qh_expcompress(int elen, double *e);
+static double *qh_expgrow(qhT *qh, double *buf, double *stackbuf, int used, int *size, int need);
+static int qh_exactdet(qhT *qh, int k, const double *a);
+static int qh_exactminor(qhT *qh, pointT **rows, int *cols, int k);
+static int qh_exactsign(qhT *qh, pointT *point, facetT *facet);
+static boolT qh_exactzero(int k, const double *a, int *cols, int onescol);
+static void qh_detlevels(int numrows, int numcols, const double *a, double *det, double *perm);
+static int qh_sosfirst(qh_sosT *sos, int m);
+static int qh_sosterm(qh_sosT *sos);
+
+/*================== functions in alphabetic order ============*/
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="detlevels">-</a>
+
+  qh_detlevels( numrows, numcols, a, det, perm )
+    Laplace expansion of the first rows of a numrows-by-numcols matrix
+    (row-major)
+
+  returns:
+    det[mask] is the determinant of the first popcount(mask) rows and the
+      columns of mask, perm[mask] its permanent with absolute values
+    for every mask of at most numrows columns
+
+  notes:
+    rounding error of det[mask] <= qh_DETerr_(k)*DBL_EPSILON*perm[mask]/2
+    for a k-by-k minor of exact entries
+*/
+static void qh_detlevels(int numrows, int numcols, const double *a, double *det, double *perm) {
+  const double *row;
+  double d, p, x;
+  int mask, bits, c, t, k;
+
+  det[0]= 1.0;
+  perm[0]= 1.0;
+  for (mask=1; mask < (1 << numcols); mask++) {
+    for (k=0, bits=mask; bits; bits &= bits - 1)
+      k++;
+    if (k > numrows)
+      continue;
+    row= a + (k-1) * numcols;
+    d= p= 0.0;
+    for (c=0, t=0; c < numcols; c++) {
+      if (!(mask & (1 << c)))
+        continue;
+      x= row[c] * det[mask ^ (1 << c)];
+      d += ((k-1+t) & 1) ? -x : x;
+      p += fabs(row[c]) * perm[mask ^ (1 << c)];
+      t++;
+    }
+    det[mask]= d;
+    perm[mask]= p;
+  }
+} /* detlevels */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="exactdet">-</a>
+
+  qh_exactdet(qh, k, a )
+    exact sign of the determinant of a k-by-k matrix (row-major)
+
+  returns:
+    -1, 0, or 1
+
+  notes:
+    Laplace expansion on expansions, by subsets of columns
+    the expansions are stored by offset in one buffer, since it grows
+    the buffers start on the stack, most determinants are zero or small
+*/
+static int qh_exactdet(qhT *qh, int k, const double *a) {
+  int start[1 << (qh_EXACTdim + 1)], len[1 << (qh_EXACTdim + 1)];
+  double bufstack[qh_EXPstack * 4], accstack[qh_EXPstack], termstack[qh_EXPstack], sumstack[qh_EXPstack];
+  double *buf= bufstack, *acc= accstack, *term= termstack, *sum= sumstack, *swap;
+  double *accinit= accstack, *suminit= sumstack;  /* swapped with acc and sum */
+  int bufsize= qh_EXPstack * 4, accsize= qh_EXPstack, termsize= qh_EXPstack, sumsize= qh_EXPstack;
+  int used, need, acclen, termlen;
+  int mask, bits, c, t, p, sign, child, swapsize;
+  const double *row;
+  double x;
+
+  buf[0]= 1.0;
+  start[0]= 0;
+  len[0]= 1;
+  used= 1;
+  for (mask=1; mask < (1 << k); mask++) {
+    for (p=0, bits=mask; bits; bits &= bits - 1)
+      p++;
+    row= a + (p-1) * k;
+    need= 0;
+    for (c=0; c < k; c++) {
+      if (mask & (1 << c))
+        need += 2 * len[mask ^ (1 << c)];
+    }
+    need= need + 1;
+    term= qh_expgrow(qh, term, termstack, 0, &termsize, need);
+    acc= qh_expgrow(qh, acc, accinit, 0, &accsize, need);
+    sum= qh_expgrow(qh, sum, suminit, 0, &sumsize, need);
+    acclen= 0;
+    for (c=0, t=0; c < k; c++) {
+      if (!(mask & (1 << c)))
+        continue;
+      child= mask ^ (1 << c);
+      x= ((p-1+t) & 1) ? -row[c] : row[c];
+      t++;
+      if (x == 0.0 || !len[child])
+        continue;
+      termlen= qh_expscale(len[child], buf + start[child], x, term);
+      acclen= qh_expsum(acclen, acc, termlen, term, sum);
+      swap= acc; acc= sum; sum= swap;
+      swapsize= accsize; accsize= sumsize; sumsize= swapsize;
+      swap= accinit; accinit= suminit; suminit= swap;
+    }
+    if (acclen)
+      acclen= qh_expcompress(acclen, acc);
+    if (acclen == 1 && acc[0] == 0.0)
+      acclen= 0;
+    buf= qh_expgrow(qh, buf, bufstack, used, &bufsize, used + acclen);
+    start[mask]= used;
+    len[mask]= acclen;
+    memcpy(buf + used, acc, (size_t)acclen * sizeof(double));
+    used += acclen;
+  }
+  mask= (1 << k) - 1;
+  if (!len[mask])
+    sign= 0;
+  else
+    sign= (buf[start[mask] + len[mask] - 1] > 0.0 ? 1 : -1);
+  if (buf != bufstack)
+    qh_free(buf);
+  if (acc != accinit)
+    qh_free(acc);
+  if (term != termstack)
+    qh_free(term);
+  if (sum != suminit)
+    qh_free(sum);
+  return sign;
+} /* exactdet */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="exactminor">-</a>
+
+  qh_exactminor(qh, rows, cols, k )
+    exact sign of the k-by-k minor of the homogeneous coordinates of rows
+    cols[] are the columns of the minor, qh.hull_dim for the column of 1's
+
+  returns:
+    -1, 0, or 1
+
+  design:
+    return 0 if the minor is zero by qh_exactzero
+    compute the determinant in floating point, with an error bound
+    if the bound does not decide the sign
+      compute it with expansions
+*/
+static int qh_exactminor(qhT *qh, pointT **rows, int *cols, int k) {
+  double a[(qh_EXACTdim + 1) * (qh_EXACTdim + 1)];
+  double det[1 << (qh_EXACTdim + 1)], perm[1 << (qh_EXACTdim + 1)];
+  double d, errbound;
+  int i, j;
+
+  for (i=0; i < k; i++) {
+    for (j=0; j < k; j++)
+      a[i*k + j]= (cols[j] == qh->hull_dim ? 1.0 : (double)rows[i][cols[j]]);
+  }
+  if (qh_exactzero(k, a, cols, qh->hull_dim))
+    return 0;
+  qh_detlevels(k, k, a, det, perm);
+  d= det[(1 << k) - 1];
+  errbound= qh_DETerr_(k) * DBL_EPSILON * perm[(1 << k) - 1];
+  if (d > errbound)
+    return 1;
+  if (d < -errbound)
+    return -1;
+  zinc_(Zexactarith);
+  return qh_exactdet(qh, k, a);
+} /* exactminor */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="exactoutside">-</a>
+
+  qh_exactoutside(qh, point, facet )
+    True if point is above facet with exact predicates ('QE')
+    qh_exactplane has set the cofactors of facet
+
+  returns:
+    False for a vertex of facet
+
+  notes:
+    T(p) = det[v1-v0, ..., vd-v0, p-v0] = sum_j c[j]*(p[j]-v0[j]) for the
+    vertices v0..vd of the facet, in the order of facet->vertices
+    T(p) is (-1)^hull_dim times the determinant of the homogeneous coordinates,
+    qh_exactsign.  Its sign for the points above the facet is qh_EXACTsign_
+    the error bound of the filter is
+      (hull_dim+2)*DBL_EPSILON*sum_j |c[j]*(p[j]-v0[j])| + E*sum_j |p[j]-v0[j]|
+    for the rounding of T(p) and of p-v0, and for the error E of the cofactors
+
+  design:
+    compute T(p) and its error bound from the cofactors of the facet
+    if the bound does not decide the sign
+      compute the sign with qh_exactsign
+*/
+boolT qh_exactoutside(qhT *qh, pointT *point, facetT *facet) {
+  double *cofactor= qh_EXACTplane_(qh, facet);
+  pointT *point0= SETfirstt_(facet->vertices, vertexT)->point;
+  double d, t= 0.0, tabs= 0.0, dabs= 0.0, errbound;
+  int k, sign;
+
+  zinc_(Zexacttests);
+  for (k=0; k < qh->hull_dim; k++) {
+    d= (double)point[k] - (double)point0[k];
+    t += cofactor[k] * d;
+    tabs += fabs(cofactor[k] * d);
+    dabs += fabs(d);
+  }
+  errbound= (qh->hull_dim + 2) * DBL_EPSILON * tabs + cofactor[qh->hull_dim] * dabs;
+  if (t > errbound)
+    sign= 1;
+  else if (t < -errbound)
+    sign= -1;
+  else {
+    sign= qh_exactsign(qh, point, facet);
+    if (qh->hull_dim & 1)
+      sign= -sign;
+  }
+  return (sign == qh_EXACTsign_(facet));
+} /* exactoutside */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="exactplane">-</a>
+
+  qh_exactplane(qh, facet )
+    set the cofactors of a simplicial facet for qh_exactoutside ('QE')
+
+  returns:
+    qh_EXACTplane_(qh, facet)[j] is c[j] of qh_exactoutside, for j < hull_dim
+    qh_EXACTplane_(qh, facet)[hull_dim] is the error bound E of the cofactors
+
+  notes:
+    called by qh_setfacetplane
+    c[j] is (-1)^(hull_dim-1+j) times the minor without column j of the rows
+    v1-v0, ..., vd-v0
+*/
+void qh_exactplane(qhT *qh, facetT *facet) {
+  double a[qh_EXACTdim * qh_EXACTdim];
+  double det[1 << qh_EXACTdim], perm[1 << qh_EXACTdim];
+  double *cofactor= qh_EXACTplane_(qh, facet), errmax= 0.0;
+  vertexT *vertex, **vertexp;
+  pointT *point0= NULL;
+  int dim= qh->hull_dim, full= (1 << dim) - 1, i= 0, j;
+
+  FOREACHvertex_(facet->vertices) {
+    if (!point0)
+      point0= vertex->point;
+    else {
+      for (j=0; j < dim; j++)
+        a[i*dim + j]= (double)vertex->point[j] - (double)point0[j];
+      i++;
+    }
+  }
+  qh_detlevels(dim-1, dim, a, det, perm);
+  for (j=0; j < dim; j++) {
+    cofactor[j]= ((dim-1+j) & 1) ? -det[full ^ (1 << j)] : det[full ^ (1 << j)];
+    maximize_(errmax, perm[full ^ (1 << j)]);
+  }
+  cofactor[dim]= (qh_DETerr_(dim-1) + dim) * DBL_EPSILON * errmax * (1.0 + (dim+2) * DBL_EPSILON);
+} /* exactplane */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="exactsign">-</a>
+
+  qh_exactsign(qh, point, facet )
+    exact sign of the determinant of the homogeneous coordinates of the
+    vertices of facet and point, with a symbolic perturbation if it is zero
+
+  returns:
+    -1 or 1, 0 if point is a vertex of facet
+
+  notes:
+    the rows are the vertices in the order of facet->vertices, then point
+    the perturbation of coordinate j of point p is eps^(2^r), where r orders
+    the pairs (j, p) by decreasing j (the last coordinate, i.e., the lifting
+    of 'd', first), then by increasing point id
+    the sign is the sign of the first nonzero coefficient of the
+    perturbed determinant, as a polynomial in eps, see qh_sosfirst
+*/
+static int qh_exactsign(qhT *qh, pointT *point, facetT *facet) {
+  qh_sosT sos;
+  vertexT *vertex, **vertexp;
+  pointT *rows[qh_EXACTdim + 1], *swappoint;
+  int cols[qh_EXACTdim + 1], ids[qh_EXACTdim + 1];
+  int dim= qh->hull_dim, i= 0, j, k, sign, swapid;
+
+  FOREACHvertex_(facet->vertices) {
+    if (vertex->point == point)
+      return 0;
+    rows[i++]= vertex->point;
+  }
+  rows[i]= point;
+  for (j=0; j <= dim; j++)
+    cols[j]= j;
+  if ((sign= qh_exactminor(qh, rows, cols, dim+1)))
+    return sign;
+  zinc_(Zexactsos);
+  for (i=0; i <= dim; i++)
+    ids[i]= qh_pointid(qh, rows[i]);
+  sign= 1;
+  for (i=1; i <= dim; i++) {  /* insertion sort by point id */
+    for (j=i; j > 0 && ids[j-1] > ids[j]; j--) {
+      swapid= ids[j]; ids[j]= ids[j-1]; ids[j-1]= swapid;
+      swappoint= rows[j]; rows[j]= rows[j-1]; rows[j-1]= swappoint;
+      sign= -sign;
+    }
+  }
+  sos.qh= qh;
+  sos.dim= dim;
+  sos.size= 0;
+  sos.numentries= 0;
+  for (i=0; i <= dim; i++) {
+    sos.rows[i]= rows[i];
+    sos.rowused[i]= sos.colused[i]= False;
+  }
+  for (j=dim; j--; ) {
+    sos.required[j]= -1;
+    for (k=1; k <= dim; k++) {
+      if (rows[k][j] != rows[0][j])
+        break;
+    }
+    if (k > dim)
+      sos.required[j]= sos.numentries;
+    for (k=0; k <= dim; k++) {
+      sos.entryrow[sos.numentries]= k;
+      sos.entrycol[sos.numentries++]= j;
+    }
+  }
+  return sign * qh_sosfirst(&sos, sos.numentries);
+} /* exactsign */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="exactupper">-</a>
+
+  qh_exactupper(qh, facet )
+    True if facet is an upper Delaunay facet with exact predicates ('QE')
+
+  notes:
+    the last coordinate of the normal of facet has the sign of
+    (-1)^(hull_dim+1) * qh_EXACTsign_ * O, for O the orientation of the
+    facet's vertices without their last coordinate (the determinant of their
+    homogeneous coordinates), i.e., the derivative of T(p) in p[hull_dim-1]
+    as for qh_setfacetplane, a vertical facet (O == 0) is upper Delaunay,
+    unless 'Qu'
+    no perturbation, the vertical facets of the perturbed points are dropped
+*/
+boolT qh_exactupper(qhT *qh, facetT *facet) {
+  vertexT *vertex, **vertexp;
+  pointT *rows[qh_EXACTdim];
+  int cols[qh_EXACTdim], i= 0, sign;
+
+  FOREACHvertex_(facet->vertices)
+    rows[i++]= vertex->point;
+  for (i=0; i < qh->hull_dim-1; i++)
+    cols[i]= i;
+  cols[i]= qh->hull_dim;
+  sign= qh_EXACTsign_(facet) * qh_exactminor(qh, rows, cols, qh->hull_dim);
+  if (!(qh->hull_dim & 1))
+    sign= -sign;
+  if (qh->UPPERdelaunay)
+    return (sign > 0);
+  return (sign >= 0);
+} /* exactupper */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="exactzero">-</a>
+
+  qh_exactzero( k, a, cols, onescol )
+    True if the k-by-k matrix a (row-major) is singular because two rows or
+    two columns are equal, or because a column is zero, or constant while
+    cols[] includes onescol (the column of 1's)
+
+  notes:
+    a quick test for qh_exactminor.  Degenerate inputs, e.g., points on a
+    grid, have many such minors in qh_sosfirst, mostly for the vertical
+    facets with coplanar points and for the duplicate points
+*/
+static boolT qh_exactzero(int k, const double *a, int *cols, int onescol) {
+  int i, j, r, isones= False;
+
+  for (j=0; j < k; j++) {
+    if (cols[j] == onescol)
+      isones= True;
+  }
+  for (j=0; j < k; j++) {
+    if (cols[j] == onescol)
+      continue;
+    for (i=1; i < k; i++) {
+      if (a[i*k + j] != a[j])
+        break;
+    }
+    if (i == k && (isones || a[j] == 0.0))
+      return True;
+    for (r=0; r < j; r++) {
+      for (i=0; i < k; i++) {
+        if (a[i*k + j] != a[i*k + r])
+          break;
+      }
+      if (i == k)
+        return True;
+    }
+  }
+  for (r=1; r < k; r++) {
+    for (i=0; i < r; i++) {
+      for (j=0; j < k; j++) {
+        if (a[r*k + j] != a[i*k + j])
+          break;
+      }
+      if (j == k)
+        return True;
+    }
+  }
+  return False;
+} /* exactzero */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="expcompress">-</a>
+
+  qh_expcompress( elen, e )
+    compress expansion e in place, as compress() of Shewchuk
+
+  returns:
+    the new length (the largest component is the last one)
+*/
+static int qh_expcompress(int elen, double *e) {
+  double Q, Qnew, q, enow;
+  int bottom, top, i;
+
+  bottom= elen - 1;
+  Q= e[bottom];
+  for (i=elen - 2; i >= 0; i--) {
+    enow= e[i];
+    qh_FASTtwosum_(Q, enow, Qnew, q);
+    if (q != 0.0) {
+      e[bottom--]= Qnew;
+      Q= q;
+    }else
+      Q= Qnew;
+  }
+  top= 0;
+  for (i=bottom + 1; i < elen; i++) {
+    qh_FASTtwosum_(e[i], Q, Qnew, q);
+    if (q != 0.0)
+      e[top++]= q;
+    Q= Qnew;
+  }
+  e[top]= Q;
+  return top + 1;
+} /* expcompress */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="expgrow">-</a>
+
+  qh_expgrow(qh, buf, stackbuf, used, size, need )
+    return buf with room for need doubles, keeping its first used doubles
+    buf is not freed if it is stackbuf, the initial buffer on the stack
+*/
+static double *qh_expgrow(qhT *qh, double *buf, double *stackbuf, int used, int *size, int need) {
+  double *newbuf;
+  int newsize;
+
+  if (need <= *size)
+    return buf;
+  newsize= 2 * (*size);
+  maximize_(newsize, need);
+  if (!(newbuf= (double *)qh_malloc((size_t)newsize * sizeof(double)))) {
+    qh_fprintf(qh, qh->ferr, 6275, "qhull error (qh_expgrow): insufficient memory for an expansion of %d doubles\n",
+      newsize);
+    qh_errexit(qh, qh_ERRmem, NULL, NULL);
+  }
+  if (used)
+    memcpy(newbuf, buf, (size_t)used * sizeof(double));
+  if (buf != stackbuf)
+    qh_free(buf);
+  *size= newsize;
+  return newbuf;
+} /* expgrow */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="expscale">-</a>
+
+  qh_expscale( elen, e, b, h )
+    h= b*e, as scale_expansion_zeroelim() of Shewchuk
+
+  returns:
+    the length of h, at most 2*elen
+*/
+static int qh_expscale(int elen, const double *e, double b, double *h) {
+  double Q, sum, hh, product1, product0;
+  int i, hindex= 0;
+
+  qh_TWOproduct_(e[0], b, Q, hh);
+  if (hh != 0.0)
+    h[hindex++]= hh;
+  for (i=1; i < elen; i++) {
+    qh_TWOproduct_(e[i], b, product1, product0);
+    qh_TWOsum_(Q, product0, sum, hh);
+    if (hh != 0.0)
+      h[hindex++]= hh;
+    qh_FASTtwosum_(product1, sum, Q, hh);
+    if (hh != 0.0)
+      h[hindex++]= hh;
+  }
+  if (Q != 0.0 || !hindex)
+    h[hindex++]= Q;
+  return hindex;
+} /* expscale */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="expsum">-</a>
+
+  qh_expsum( elen, e, flen, f, h )
+    h= e+f, as fast_expansion_sum_zeroelim() of Shewchuk
+    h is distinct from e and f
+
+  returns:
+    the length of h, at most elen+flen (at least 1 if elen+flen > 0)
+
+  notes:
+    takes the components of e and f by increasing magnitude
+    Two-Sum instead of Fast-Two-Sum for the first one, the result is the same
+*/
+static int qh_expsum(int elen, const double *e, int flen, const double *f, double *h) {
+  double Q, Qnew, hh, next;
+  int ei= 0, fi= 0, hindex= 0;
+
+  if (!elen) {
+    memcpy(h, f, (size_t)flen * sizeof(double));
+    return flen;
+  }
+  if (!flen) {
+    memcpy(h, e, (size_t)elen * sizeof(double));
+    return elen;
+  }
+  if ((f[0] > e[0]) == (f[0] > -e[0]))
+    Q= e[ei++];
+  else
+    Q= f[fi++];
+  while (ei < elen || fi < flen) {
+    if (fi == flen || (ei < elen && (f[fi] > e[ei]) == (f[fi] > -e[ei])))
+      next= e[ei++];
+    else
+      next= f[fi++];
+    qh_TWOsum_(Q, next, Qnew, hh);
+    Q= Qnew;
+    if (hh != 0.0)
+      h[hindex++]= hh;
+  }
+  if (Q != 0.0 || !hindex)
+    h[hindex++]= Q;
+  return hindex;
+} /* expsum */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="sosfirst">-</a>
+
+  qh_sosfirst( sos, m )
+    sign of the first nonzero term of the perturbed determinant, for the
+    terms of sos->term and a subset of the first m perturbed entries
+
+  returns:
+    -1 or 1, 0 if these terms are zero
+
+  notes:
+    a term is the product of the perturbations of a set S of entries, at most
+    one per row and column, times the minor without their rows and columns
+    the terms are in order of decreasing significance if the sets S are in
+    increasing order of the binary numbers sum(2^r), r the rank of the entries
+    the empty set is the determinant, which is zero
+    a set of one entry per perturbed column has a nonzero minor, the 1 of its
+    remaining row
+    a set without an entry of a constant column has a zero minor (the column
+    is a multiple of the column of 1's), sos->required
+*/
+static int qh_sosfirst(qh_sosT *sos, int m) {
+  int row, col, sign;
+
+  for (col=0; col < sos->dim; col++) {
+    if (sos->required[col] >= m && !sos->colused[col])
+      return 0;
+  }
+  if (!m)
+    return (sos->size ? qh_sosterm(sos) : 0);
+  if ((sign= qh_sosfirst(sos, m-1)))
+    return sign;
+  row= sos->entryrow[m-1];
+  col= sos->entrycol[m-1];
+  if (sos->rowused[row] || sos->colused[col])
+    return 0;
+  sos->rowused[row]= sos->colused[col]= True;
+  sos->termrow[sos->size]= row;
+  sos->termcol[sos->size++]= col;
+  sign= qh_sosfirst(sos, m-1);
+  sos->size--;
+  sos->rowused[row]= sos->colused[col]= False;
+  return sign;
+} /* sosfirst */
+
+/*-<a                             href="qh-geom_r.htm#TOC"
+  >-------------------------------</a><a name="sosterm">-</a>
+
+  qh_sosterm( sos )
+    sign of the coefficient of the term of sos->termrow/termcol
+
+  notes:
+    the sign of the Laplace expansion along each entry, in the order of the
+    term, times the sign of the remaining minor
+*/
+static int qh_sosterm(qh_sosT *sos) {
+  pointT *rows[qh_EXACTdim + 1];
+  int cols[qh_EXACTdim + 1];
+  int i, j, row, col, k, sign= 1;
+
+  for (i=0; i < sos->size; i++) {
+    row= sos->termrow[i];
+    col= sos->termcol[i];
+    for (j=0; j < i; j++) {
+      if (sos->termrow[j] < sos->termrow[i])
+        row--;
+      if (sos->termcol[j] < sos->termcol[i])
+        col--;
+    }
+    if ((row + col) & 1)
+      sign= -sign;
+  }
+  for (i=0, k=0; i <= sos->dim; i++) {
+    if (!sos->rowused[i])
+      rows[k++]= sos->rows[i];
+  }
+  for (i=0, k=0; i <= sos->dim; i++) {
+    if (!sos->colused[i])
+      cols[k++]= i;  /* sos->dim is qh.hull_dim, the column of 1's */
+  }
+  return sign * qh_exactminor(sos->qh, rows, cols, k);
+} /* sosterm */
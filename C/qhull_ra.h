@@ -125,6 +125,8 @@ void    qh_findhorizon(qhT *qh, pointT *point, facetT *facet, int *goodvisible,i
 pointT *qh_nextfurthest(qhT *qh, facetT **visible);
 void    qh_partitionall(qhT *qh, setT *vertices, pointT *points,int npoints);
 void    qh_partitioncoplanar(qhT *qh, pointT *point, facetT *facet, realT *dist);
+void    qh_partitionfound(qhT *qh, pointT *point, facetT *bestfacet, realT bestdist,
+             boolT isoutside, int numpart);
 void    qh_partitionpoint(qhT *qh, pointT *point, facetT *facet);
 void    qh_partitionvisible(qhT *qh, boolT allpoints, int *numpoints);
 void    qh_precision(qhT *qh, const char *reason);
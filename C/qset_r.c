@@ -708,6 +708,7 @@ int qh_setequal_skip(setT *setA, int skipA, setT *setB, int skipB) {
 
   notes:
     set may be NULL
+    an inline set (qh_setinline) is freed with its owner
 
   design:
     free array
@@ -717,14 +718,14 @@ void qh_setfree(qhT *qh, setT **setp) {
   int size;
   void **freelistp;  /* used if !qh_NOmem by qh_memfree_() */
 
-  if (*setp) {
+  if (*setp && !(*setp)->inlineset) {
     size= sizeof(setT) + ((*setp)->maxsize)*SETelemsize;
     if (size <= qh->qhmem.LASTsize) {
       qh_memfree_(qh, *setp, size, freelistp);
     }else
       qh_memfree(qh, *setp, size);
-    *setp= NULL;
   }
+  *setp= NULL;
 } /* setfree */
 
 
@@ -770,7 +771,7 @@ void qh_setfree2(qhT *qh, setT **setp, int elemsize) {
 void qh_setfreelong(qhT *qh, setT **setp) {
   int size;
 
-  if (*setp) {
+  if (*setp && !(*setp)->inlineset) {
     size= sizeof(setT) + ((*setp)->maxsize)*SETelemsize;
     if (size > qh->qhmem.LASTsize) {
       qh_memfree(qh, *setp, size);
@@ -836,6 +837,31 @@ int qh_setindex(setT *set, void *atelem) {
 } /* setindex */
 
 
+/*-<a                             href="qh-set_r.htm#TOC"
+  >-------------------------------<a name="setinline">-</a>
+
+  qh_setinline( storage, setsize )
+    creates an empty set in storage, for setsize elements
+
+  returns:
+    the set, at the start of storage
+
+  notes:
+    storage has SETinlinesize_(setsize) bytes, and is usually in the memory
+      of the owner of the set, e.g., facet->vertices (qh_newfacet)
+    qh_setfree and qh_setfreelong set it to NULL without freeing it
+    qh_setlarger and qh_setappend_set copy it to a new set when it is full
+*/
+setT *qh_setinline(void *storage, int setsize) {
+  setT *set= (setT *)storage;
+
+  set->maxsize= setsize;
+  set->inlineset= 1;
+  set->e[setsize].i= 1;
+  set->e[0].p= NULL;
+  return(set);
+} /* setinline */
+
 /*-<a                             href="qh-set_r.htm#TOC"
   >-------------------------------<a name="setlarger">-</a>
 
@@ -845,6 +871,7 @@ int qh_setindex(setT *set, void *atelem) {
   notes:
     the set is at least twice as large
     if temp set, updates qh->qhmem.tempstack
+    an inline set (qh_setinline) stays in the memory of its owner
 
   design:
     creates a new set
@@ -940,6 +967,7 @@ setT *qh_setnew(qhT *qh, int setsize) {
   }else
     set= (setT*)qh_memalloc(qh, size);
   set->maxsize= setsize;
+  set->inlineset= 0;
   set->e[setsize].i= 1;
   set->e[0].p= NULL;
   return(set);
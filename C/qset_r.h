@@ -87,6 +87,8 @@ union setelemT {
 
 struct setT {
   int maxsize;          /* maximum number of elements (except NULL) */
+  int inlineset;        /* True if stored in the memory of its owner by
+                           qh_setinline.  qset_r.c never frees it */
   setelemT e[1];        /* array of pointers, tail is NULL */
                         /* last slot (unless NULL) is actual size+1
                            e[maxsize]==NULL or e[e[maxsize]-1]==NULL */
@@ -107,6 +109,14 @@ struct setT {
 
 /*=========== -macros- =========================*/
 
+/*-<a                                 href="qh-set_r.htm#TOC"
+  >-----------------------------------</a><a name="SETinlinesize_">-</a>
+
+  SETinlinesize_(setsize)
+    size in bytes of the storage of qh_setinline for setsize elements
+*/
+#define SETinlinesize_(setsize) ((int)sizeof(setT) + (setsize) * SETelemsize)
+
 /*-<a                                 href="qh-set_r.htm#TOC"
   >-----------------------------------</a><a name="FOREACHsetelement_">-</a>
 
@@ -479,6 +489,7 @@ void  qh_setfree2(qhT *qh, setT **setp, int elemsize);
 void  qh_setfreelong(qhT *qh, setT **set);
 int   qh_setin(setT *set, void *setelem);
 int qh_setindex(setT *set, void *setelem);
+setT *qh_setinline(void *storage, int setsize);
 void  qh_setlarger(qhT *qh, setT **setp);
 void *qh_setlast(setT *set);
 setT *qh_setnew(qhT *qh, int size);
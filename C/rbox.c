@@ -0,0 +1,92 @@
+/* rbox point generator, writing into a coordinate buffer */
+#include "libqhull_r.h"
+#include "rbox.h"
+#include <stdlib.h>
+
+/* append a coordinate to the buffer, skipping the last column of the rows */
+static void rboxappend_(RboxT* rbox, double x){
+  if(rbox->points && rbox->count < rbox->n * rbox->dim){
+    unsigned row = rbox->count / rbox->dim, column = rbox->count % rbox->dim;
+    rbox->points[row * (rbox->dim + 1) + column] = x;
+    rbox->count++;
+  }
+}
+
+/* store the output of qh_fprintf_rbox: the header gives the dimension and
+   the number of points, the coordinates are appended to the buffer, in rows
+   of dim+1 coordinates */
+void rboxcollect(RboxT* rbox, int msgcode, va_list args)
+{
+  switch(msgcode){
+    case 9391: /* cdd header: command, number of points, dim+1, type */
+      va_arg(args, char*);
+      rbox->n   = (unsigned) va_arg(args, int);
+      rbox->dim = (unsigned) va_arg(args, int);
+      break;
+    case 9392: /* dim, number of points */
+      rbox->dim = (unsigned) va_arg(args, int);
+      rbox->n   = (unsigned) va_arg(args, int);
+      break;
+    case 9393: /* dim, command, number of points */
+      rbox->dim = (unsigned) va_arg(args, int);
+      va_arg(args, char*);
+      rbox->n   = (unsigned) va_arg(args, int);
+      break;
+    case 9403: case 9405: case 9407: /* 1, 2 or 3 integer coordinates */
+      for(int i = 0; i <= (msgcode - 9403) / 2; i++){
+        int x = va_arg(args, int);
+        rboxappend_(rbox, (double) x);
+      }
+      return;
+    case 9404: case 9406: case 9408: /* 1, 2 or 3 real coordinates */
+      for(int i = 0; i <= (msgcode - 9404) / 2; i++){
+        double x = va_arg(args, double);
+        rboxappend_(rbox, x);
+      }
+      return;
+    default: /* newlines and trailers */
+      return;
+  }
+  free(rbox->points);
+  rbox->points = malloc((rbox->n + 1) * (rbox->dim + 1) * sizeof(double));
+  rbox->nomem  = rbox->points == NULL;
+  rbox->count  = 0;
+} /* rboxcollect */
+
+/* run rbox with the given command, e.g. "rbox 1000 s D3", and return the
+   coordinates of the generated points, in n rows of dim+1 coordinates
+   followed by a spare row: the last column and the last row are left for
+   the tessellation, which lifts the sites in place (see liftsites); the
+   dimension and the number of points are written in dim and n; the exit
+   code is the one of qh_rboxpoints, qh_ERRmem if the buffer cannot be
+   allocated, and qh_ERRinput if the output is incomplete */
+double* rboxpoints(
+  char*     command,
+  unsigned* dim,
+  unsigned* n,
+  unsigned* exitcode
+)
+{
+  qhT qh_qh;
+  qhT *qh= &qh_qh;
+  RboxT rbox = {.points = NULL, .dim = 0, .n = 0, .count = 0, .nomem = 0};
+  qh_zero(qh, stderr);
+  qh->ferr = stderr; /* rbox errors */
+  qh->cpp_object = &rbox;
+  *exitcode = (unsigned) qh_rboxpoints(qh, command);
+  qh->cpp_object = NULL;
+  if(!(*exitcode) && rbox.nomem){
+    *exitcode = qh_ERRmem;
+  }
+  if(!(*exitcode) && (rbox.points == NULL || rbox.count != rbox.n * rbox.dim)){
+    *exitcode = qh_ERRinput;
+  }
+  if(*exitcode){
+    free(rbox.points);
+    rbox.points = NULL;
+    rbox.dim = rbox.n = 0;
+  }
+  *dim = rbox.dim;
+  *n   = rbox.n;
+  return rbox.points;
+} /* rboxpoints */
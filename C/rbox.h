@@ -0,0 +1,14 @@
+#include <stdarg.h>
+
+/* points generated by qh_rboxpoints, collected by qh_fprintf_rbox when
+   qh->cpp_object points to a RboxT */
+typedef struct Rbox {
+  double*  points; /* n+1 rows of dim+1 coordinates, see rboxpoints */
+  unsigned dim;
+  unsigned n;
+  unsigned count;  /* number of coordinates received so far */
+  unsigned nomem;  /* 1 if the buffer could not be allocated */
+} RboxT;
+
+void rboxcollect(RboxT*, int, va_list);
+double* rboxpoints(char*, unsigned*, unsigned*, unsigned*);
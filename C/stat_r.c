@@ -67,6 +67,7 @@ void qh_allstatB(qhT *qh) {
   zdef_(wadd, Wcpu, "cpu seconds for qhull after input", -1);
   zdef_(zinc, Ztotvertices, "vertices created altogether", -1);
   zzdef_(zinc, Zsetplane, "facets created altogether", -1);
+  zdef_(zinc, Zsetplanesimplex, "  hyperplanes by qh_sethyperplane_simplex", -1);
   zdef_(zinc, Ztotridges, "ridges created altogether", -1);
   zdef_(zinc, Zpostfacets, "facets before post merge", -1);
   zdef_(zadd, Znummergetot, "average merges per facet(at most 511)", Znumfacets);
@@ -129,6 +130,8 @@ void qh_allstatD(qhT *qh) {
   zdef_(zmax, Zfindnewmax, " max. facets tested", -1);
   zdef_(zinc, Zfindnewjump, " ave. clearly better", Zfindnew);
   zdef_(zinc, Zfindnewsharp, " calls due to qh_sharpnewfacets", -1);
+  zdef_(zinc, Zfindnewbatch, " calls replayed from the scans of qh_partitionbatch", -1);
+  zdef_(zinc, Zpartbatch, "re-partitions of visible facets with threads", -1);
   zdef_(zinc, Zfindhorizon, "calls to findhorizon", -1);
   zdef_(zadd, Zfindhorizontot, " ave. facets tested", Zfindhorizon);
   zdef_(zmax, Zfindhorizonmax, " max. facets tested", -1);
@@ -155,6 +158,11 @@ void qh_allstatE(qhT *qh) {
   zdef_(zinc, Zdistio, "distance tests for output", -1);
   zdef_(zinc, Zdiststat, "distance tests for statistics", -1);
   zdef_(zinc, Zdistplane, "total number of distance tests", -1);
+  zdef_(zinc, Zexacttests, "exact predicates for 'QE'", -1);
+  zdef_(zinc, Zexactarith, "  determinants in exact arithmetic", -1);
+  zdef_(zinc, Zexactsos, "  decided by symbolic perturbation", -1);
+  zdef_(zinc, Zfindexactwalk, "  outside facets found by the walk of qh_findbestexact", -1);
+  zdef_(zinc, Zfindexactscan, "  scans of the facets after a flat facet in qh_findbestexact", -1);
   zdef_(zinc, Ztotpartcoplanar, "partitions of coplanar points or deleted vertices", -1);
   zzdef_(zinc, Zpartcoplanar, "   distance tests for these partitions", -1);
   zdef_(zinc, Zcomputefurthest, "distance tests for computing furthest", -1);
@@ -138,11 +138,16 @@ enum qh_statistics {     /* alphabetical after Z/W */
     Wduplicatetot,
     Zdupridge,
     Zdupsame,
+    Zexactarith,
+    Zexactsos,
+    Zexacttests,
     Zflipped,
     Wflippedmax,
     Wflippedtot,
     Zflippedfacets,
     Zfindbest,
+    Zfindexactscan,
+    Zfindexactwalk,
     Zfindbestmax,
     Zfindbesttot,
     Zfindcoplanar,
@@ -156,6 +161,7 @@ enum qh_statistics {     /* alphabetical after Z/W */
     Zfindnewtot,
     Zfindnewjump,
     Zfindnewsharp,
+    Zfindnewbatch,
     Zgauss0,
     Zgoodfacet,
     Zhashlookup,
@@ -220,6 +226,7 @@ enum qh_statistics {     /* alphabetical after Z/W */
     Znumvneighbors,
     Zonehorizon,
     Zpartangle,
+    Zpartbatch,
     Zpartcoplanar,
     Zpartflip,
     Zparthorizon,
@@ -254,6 +261,7 @@ enum qh_statistics {     /* alphabetical after Z/W */
     Wridgeokmax,
     Zsearchpoints,
     Zsetplane,
+    Zsetplanesimplex,
     Ztestvneighbor,
     Ztotcheck,
     Ztothorizon,
@@ -0,0 +1,88 @@
+/* ring buffer of trace events, see trace.h */
+#include "trace.h"
+#include "utils.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+static TraceEventT  traceevents_[TRACE_SIZE];
+static atomic_uint  tracecount_;   /* number of events recorded */
+static atomic_uint  tracethreads_; /* number of threads seen */
+static _Thread_local unsigned tracetid_ = 0; /* 0 if not numbered yet */
+static _Thread_local const char* tracespans_[TRACE_DEPTH]; /* open spans */
+static _Thread_local unsigned tracedepth_ = 0; /* number of open spans */
+
+/* whether the library has been compiled with the trace points */
+unsigned traceenabled(void){
+#ifdef DELAUNAY_TRACE
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+/* records an event; the slot is reserved atomically, so several threads can
+   record at the same time */
+void traceevent(const char* name, char phase){
+  if(!tracetid_){
+    tracetid_ = atomic_fetch_add(&tracethreads_, 1) + 1;
+  }
+  unsigned i = atomic_fetch_add(&tracecount_, 1) % TRACE_SIZE;
+  strncpy(traceevents_[i].name, name, TRACE_NAMELEN - 1);
+  traceevents_[i].name[TRACE_NAMELEN - 1] = '\0';
+  traceevents_[i].phase = phase;
+  traceevents_[i].tid   = tracetid_;
+  traceevents_[i].ts    = walltime() * 1e6;
+  if(phase == 'B'){
+    if(tracedepth_ < TRACE_DEPTH){
+      tracespans_[tracedepth_] = name;
+    }
+    tracedepth_++;
+  }else if(phase == 'E' && tracedepth_){
+    tracedepth_--;
+  }
+}
+
+/* number of spans begun and not ended by the calling thread */
+unsigned tracedepth(void){
+  return tracedepth_;
+}
+
+/* ends the spans of the calling thread until depth of them are open, the
+   innermost first; for a longjmp or a cancellation which skips the end
+   events; the names are those given to the begin events, which must still
+   be valid (string literals at the trace points) */
+void traceunwind(unsigned depth){
+  while(tracedepth_ > depth){
+    unsigned k = tracedepth_ - 1;
+    traceevent(k < TRACE_DEPTH ? tracespans_[k] : "unwind", 'E');
+  }
+}
+
+/* forgets the recorded events */
+void traceclear(void){
+  atomic_store(&tracecount_, 0);
+}
+
+/* writes the recorded events, oldest first, as Chrome trace JSON; must not
+   be called while events are recorded; returns 0 if the file cannot be
+   opened */
+unsigned tracewrite(const char* filename){
+  FILE* f = fopen(filename, "w");
+  if(!f){
+    return 0;
+  }
+  unsigned count = atomic_load(&tracecount_);
+  unsigned first = count > TRACE_SIZE ? count - TRACE_SIZE : 0;
+  fprintf(f, "{\"traceEvents\":[");
+  for(unsigned k=first; k < count; k++){
+    TraceEventT* e = &traceevents_[k % TRACE_SIZE];
+    fprintf(f, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,"
+               "\"pid\":1,\"tid\":%u%s}",
+            k == first ? "" : ",", e->name, e->phase, e->ts, e->tid,
+            e->phase == 'i' ? ",\"s\":\"t\"" : "");
+  }
+  fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+  fclose(f);
+  return 1;
+}
@@ -0,0 +1,35 @@
+/* event tracing, enabled by compiling with -DDELAUNAY_TRACE; the trace
+   points expand to nothing otherwise; the events are kept in a ring buffer
+   (the last TRACE_SIZE ones) and written as Chrome trace JSON, to be opened
+   with chrome://tracing or https://ui.perfetto.dev */
+#define TRACE_SIZE    65536
+#define TRACE_NAMELEN 32
+#define TRACE_DEPTH   64 /* open spans kept per thread, see traceunwind */
+
+typedef struct TraceEvent {
+  char     name[TRACE_NAMELEN];
+  char     phase; /* 'B' begin, 'E' end, 'i' instant */
+  unsigned tid;   /* number of the thread, in order of first event */
+  double   ts;    /* microseconds */
+} TraceEventT;
+
+#ifdef DELAUNAY_TRACE
+#define TRACE_BEGIN(name)   traceevent(name, 'B')
+#define TRACE_END(name)     traceevent(name, 'E')
+#define TRACE_INSTANT(name) traceevent(name, 'i')
+#define TRACE_OPEN()        tracedepth()
+#define TRACE_UNWIND(depth) traceunwind(depth)
+#else
+#define TRACE_BEGIN(name)
+#define TRACE_END(name)
+#define TRACE_INSTANT(name)
+#define TRACE_OPEN()        0
+#define TRACE_UNWIND(depth) ((void)(depth))
+#endif
+
+unsigned traceenabled(void);
+void traceevent(const char*, char);
+unsigned tracedepth(void);
+void traceunwind(unsigned);
+void traceclear(void);
+unsigned tracewrite(const char*);
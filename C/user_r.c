@@ -178,6 +178,27 @@ int qh_new_qhull(qhT *qh, int dim, int numpoints, coordT *points, boolT ismalloc
   return exitcode;
 } /* new_qhull */
 
+/*-<a                             href="qh-user_r.htm#TOC"
+  >-------------------------------</a><a name="errcancel">-</a>
+
+  qh_errcancel(qh )
+    exit quietly from qhull with qh_ERRcancel
+    called when qh.progress_fn requests a cancellation
+
+  notes:
+    unlike qh_errexit, it does not report the facets or the statistics
+    the caller frees the hull with qh_freeqhull as after any error
+*/
+void qh_errcancel(qhT *qh) {
+
+  trace1((qh, qh->ferr, 1064, "qh_errcancel: cancelled after point p%d\n", qh->furthest_id));
+  if (!qh->QHULLfinished)
+    qh->hulltime= qh_CPUclock - qh->hulltime;
+  qh->NOerrexit= True;
+  qh->ALLOWrestart= False;  /* longjmp will undo qh_build_withrestart */
+  longjmp(qh->errexit, qh_ERRcancel);
+} /* errcancel */
+
 /*-<a                             href="qh-user_r.htm#TOC"
   >-------------------------------</a><a name="errexit">-</a>
 
@@ -61,7 +61,7 @@ Code flags --
   See QhullError.h for 10000 errors.
 
   def counters =  [27, 1048, 2059, 3026, 4068, 5003,
-     6273, 7081, 8147, 9411, 10000, 11029]
+     6277, 7081, 8147, 9411, 10000, 11029]
 
   See: qh_ERR* [libqhull_r.h]
 */
@@ -439,6 +439,55 @@ stop after qh_JOGGLEmaxretry attempts
 */
 #define qh_INITIALmax 8
 
+/*-<a                             href="qh-user_r.htm#TOC"
+  >--------------------------------</a><a name="PARTITIONvisible">-</a>
+
+  qh_PARTITIONvisible
+    with qh.NUMthreads > 1, qh_partitionvisible uses threads for at least
+    this number of distance tests (outside points times new facets) per thread
+
+  notes:
+    the partition of each added point has its own threads
+    only with qh.findbestnew, i.e., after merges (bench/qhull/partitionvisible.c)
+*/
+#define qh_PARTITIONvisible 65536
+
+/*-<a                             href="qh-user_r.htm#TOC"
+  >--------------------------------</a><a name="SIMDdist">-</a>
+
+  qh_SIMDdist
+    if 1, qh_distplanes and qh_distfacets use AVX2 or SSE2 on x86
+    processors that have it (gcc or clang, checked at run time)
+
+  notes:
+    not with REALfloat, nor if the compiler may fuse multiply-adds
+    (__FMA__), since qh_distplane would not give the same distances
+*/
+#define qh_SIMDdist 1
+
+/*-<a                             href="qh-user_r.htm#TOC"
+  >--------------------------------</a><a name="SIMPLEXplane">-</a>
+
+  qh_SIMPLEXplane
+    if 1, qh_setfacetplane sets the hyperplane of a simplicial facet in 5-d
+    to 7-d with qh_sethyperplane_simplex, a kernel for each dimension,
+    instead of copying its vertices to qh.gm_matrix for qh_sethyperplane_gauss
+
+  notes:
+    these are the facets of a Delaunay triangulation of 4-d to 6-d sites
+    the hyperplanes are the same as with qh_sethyperplane_gauss
+*/
+#define qh_SIMPLEXplane 1
+
+/*-<a                             href="qh-user_r.htm#TOC"
+  >--------------------------------</a><a name="DISTbatch">-</a>
+
+  qh_DISTbatch
+    number of facets given at once to qh_distfacets by searches
+    that stop at the first facet clearly above the point
+*/
+#define qh_DISTbatch 8
+
 /*============================================================*/
 /*============= memory constants =============================*/
 /*============================================================*/
@@ -486,6 +535,43 @@ stop after qh_JOGGLEmaxretry attempts
 */
 #define qh_MEMinitbuf 0x20000      /* initially allocate 128K buffer */
 
+/*-<a                             href="qh-user_r.htm#TOC"
+  >--------------------------------</a><a name="MEMpool">-</a>
+
+  qh_MEMpool
+    if 1, the short memory buffers may come from a pool of chunks shared
+    by all qhT (qh.qhmem.POOLbuffers)
+
+  notes:
+    the pool is locked with a POSIX mutex
+    set qh_MEMpool to 0 for a build without pthreads
+*/
+#define qh_MEMpool 1
+
+/*-<a                             href="qh-user_r.htm#TOC"
+  >--------------------------------</a><a name="MEMpoolchunk">-</a>
+
+  qh_MEMpoolchunk
+    size of the chunks of the pool of short memory buffers
+
+  notes:
+    2 MB is the size of a transparent huge page on x86-64 Linux
+    used by qh_initqhull_mem if qh.qhmem.POOLbuffers
+*/
+#define qh_MEMpoolchunk 0x200000
+
+/*-<a                             href="qh-user_r.htm#TOC"
+  >--------------------------------</a><a name="MEMpoolmax">-</a>
+
+  qh_MEMpoolmax
+    maximum number of idle chunks kept by the pool
+
+  notes:
+    qh_memfreeshort frees the other chunks
+    qh_mempoolrelease frees the idle chunks
+*/
+#define qh_MEMpoolmax 16
+
 /*-<a                             href="qh-user_r.htm#TOC"
   >--------------------------------</a><a name="INFINITE">-</a>
 
@@ -554,6 +640,27 @@ stop after qh_JOGGLEmaxretry attempts
 */
 #define qh_KEEPstatistics 1
 
+/*-<a                             href="qh-user_r.htm#TOC"
+  >--------------------------------</a><a name="LEANfacets">-</a>
+
+  qh_LEANfacets
+    slim facets for the simplicial Delaunay triangulations of delaunay.c
+    =1 to store facet->normal with the facet, and to remove facet->maxoutside
+
+  notes:
+    one allocation of qh.facet_size per facet for the facet, its neighbors,
+      its vertices and its normal (qh_newfacet, qh_INLINEnormal_)
+    the tricoplanar facets of qh_triangulate share a copy of the normal
+    sets qh_MAXoutside to 0, the outer planes use qh.max_outside
+    short memory per facet for 'd Qt Qbb Qx' of uniform random points, with
+      the sets of the vertex neighbors:
+        3-d, 100000 points   255 bytes,  247 bytes if qh_LEANfacets
+        4-d,  20000 points   274 bytes,  266 bytes
+        5-d,   3000 points   296 bytes,  288 bytes
+      and one allocation per facet instead of two
+*/
+#define qh_LEANfacets 1
+
 /*-<a                             href="qh-user_r.htm#TOC"
   >--------------------------------</a><a name="MAXoutside">-</a>
 
@@ -564,8 +671,13 @@ stop after qh_JOGGLEmaxretry attempts
   notes:
     this takes a realT per facet and slightly slows down qhull
     it produces better outer planes for geomview output
+    0 if qh_LEANfacets
 */
+#if qh_LEANfacets
+#define qh_MAXoutside 0
+#else
 #define qh_MAXoutside 1
+#endif
 
 /*-<a                             href="qh-user_r.htm#TOC"
   >--------------------------------</a><a name="NOmerge">-</a>
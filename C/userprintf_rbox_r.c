@@ -19,6 +19,7 @@
 */
 
 #include "libqhull_r.h"
+#include "rbox.h"
 
 #include <stdarg.h>
 #include <stdio.h>
@@ -35,11 +36,18 @@
      same as fprintf()
      fgets() is not trapped like fprintf()
      exit qh_fprintf_rbox via qh_errexit_rbox()
+     if qh->cpp_object is set, the points are collected in this RboxT (rbox.c)
 */
 
 void qh_fprintf_rbox(qhT *qh, FILE *fp, int msgcode, const char *fmt, ... ) {
     va_list args;
 
+    if (qh->cpp_object && msgcode >= MSG_OUTPUT && msgcode < MSG_QHULL_ERROR) {
+        va_start(args, fmt);
+        rboxcollect((RboxT *)qh->cpp_object, msgcode, args);
+        va_end(args);
+        return;
+    }
     if (!fp) {
         qh_fprintf_stderr(6231, "Qhull internal error (userprintf_rbox_r.c): fp is 0.  Wrong qh_fprintf_rbox called.\n");
         qh_errexit_rbox(qh, 6231);
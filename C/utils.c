@@ -1,6 +1,8 @@
 #include <stdlib.h> // to use realloc
 #include <math.h> // to use NAN
 #include <stdio.h> // to use printf
+#include <time.h> // to use timespec_get
+#include "utils.h"
 
 double* getpoint(double* points, unsigned dim, unsigned id){
   double* out = malloc(dim * sizeof(double));
@@ -28,6 +30,15 @@ double* middle(double* p1, double* p2, unsigned dim){
   return out;
 }
 
+/* copy of a vector */
+double* copyvector(double* x, unsigned dim){
+  double* out = malloc(dim * sizeof(double));
+  for(unsigned i=0; i < dim; i++){
+    out[i] = x[i];
+  }
+  return out;
+}
+
 /* vector of NANs */
 double* nanvector(int dim){
   double* out = malloc(dim * sizeof(double));
@@ -89,3 +100,10 @@ double squaredDistance(double* p1, double* p2, unsigned dim){
   }
   return out;
 }
+
+/* wall time in seconds */
+double walltime(){
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
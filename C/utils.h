@@ -9,6 +9,8 @@ void appendu(unsigned, unsigned**, unsigned, unsigned*);
 
 double* nanvector(int);
 
+double* copyvector(double*, unsigned);
+
 double* middle(double*, double*, unsigned);
 
 double* getpoint(double*, unsigned, unsigned);
@@ -18,3 +20,5 @@ double dotproduct(double*, double*, unsigned);
 unsigned* uzeros(unsigned);
 
 double squaredDistance(double*, double*, unsigned);
+
+double walltime();
@@ -0,0 +1,198 @@
+module Main ( main ) where
+import           Control.DeepSeq             ( NFData(rnf), force )
+import           Control.Monad               ( when )
+import           Criterion.Main              ( Benchmark,
+                                               bench,
+                                               bgroup,
+                                               defaultMain,
+                                               env,
+                                               envWithCleanup,
+                                               nfIO,
+                                               whnfIO )
+import           Data.Bits                   ( shiftR, xor )
+import           Data.IntMap.Strict          ( IntMap )
+import           Data.List                   ( unfoldr )
+import           Data.Word                   ( Word64 )
+import           Foreign.C.Types             ( CDouble )
+import           Foreign.Marshal.Alloc       ( alloca, free )
+import           Foreign.Marshal.Array       ( newArray )
+import           Foreign.Ptr                 ( Ptr, nullPtr )
+import           Foreign.Storable            ( peek )
+import           Geometry.Delaunay           ( DelaunayOptions(..),
+                                               Premerge(..),
+                                               Site,
+                                               Tessellation(..),
+                                               Tile,
+                                               TileFacet,
+                                               Triangulation(..),
+                                               defaultOptions,
+                                               delaunay,
+                                               delaunayWith )
+import           Geometry.Delaunay.Rbox      ( cloudPoints, rbox )
+import           Geometry.Delaunay.CDelaunay ( CTessellation,
+                                               c_freeTessellation,
+                                               c_tessellation,
+                                               cTessellationToTessellation )
+import           System.Environment          ( lookupEnv )
+
+-- the distributions of the points, and whether to add the point at infinity
+distributions :: [(String, Int -> Int -> IO [[Double]], Bool)]
+distributions =
+  [ ("cube",        pure2 cube,      False)
+  , ("sphere",      pure2 sphere,    True)
+  , ("grid",        pure2 grid,      True)
+  , ("clustered",   pure2 clustered, False)
+  , ("rbox-cube",   rboxDist "",     False)
+  , ("rbox-sphere", rboxDist " s",   True) ]
+  where
+    pure2 f dim n = return (f dim n)
+
+-- points generated by qhull's rbox, with the given options
+rboxDist :: String -> Int -> Int -> IO [[Double]]
+rboxDist options dim n =
+  rbox ("rbox " ++ show n ++ " D" ++ show dim ++ options) >>= cloudPoints
+
+-- uniform in the unit cube
+cube :: Int -> Int -> [[Double]]
+cube dim n = take n (chunksOf dim (uniforms 1))
+
+-- uniform on the unit sphere (cospherical points)
+sphere :: Int -> Int -> [[Double]]
+sphere dim n = take n (map normalize (chunksOf dim (gaussians 2)))
+  where
+    normalize x = let r = sqrt (sum (map (^ (2 :: Int)) x)) in map (/ r) x
+
+-- regular grid (many cospherical points)
+grid :: Int -> Int -> [[Double]]
+grid dim n = take n (mapM (const [0 .. fromIntegral (k-1)]) [1 .. dim])
+  where
+    k = ceiling (fromIntegral n ** (1 / fromIntegral dim) :: Double) :: Int
+
+-- gaussian clusters around ten centers
+clustered :: Int -> Int -> [[Double]]
+clustered dim n =
+  take n (zipWith (zipWith (+)) (cycle centers)
+                  (map (map (* 0.02)) (chunksOf dim (gaussians 3))))
+  where
+    centers = take 10 (chunksOf dim (uniforms 4))
+
+chunksOf :: Int -> [a] -> [[a]]
+chunksOf k = unfoldr (\xs -> Just (splitAt k xs))
+
+-- splitmix64 stream of uniform numbers in [0,1)
+uniforms :: Word64 -> [Double]
+uniforms = unfoldr (Just . next)
+  where
+    next s = (fromIntegral (z `shiftR` 11) / 9007199254740992, s')
+      where
+        s' = s + 0x9E3779B97F4A7C15
+        z1 = (s' `xor` (s' `shiftR` 30)) * 0xBF58476D1CE4E5B9
+        z2 = (z1 `xor` (z1 `shiftR` 27)) * 0x94D049BB133111EB
+        z  = z2 `xor` (z2 `shiftR` 31)
+
+-- standard gaussian numbers (Box-Muller)
+gaussians :: Word64 -> [Double]
+gaussians seed = go (uniforms seed)
+  where
+    go (u1 : u2 : us) =
+      let r = sqrt (-2 * log (1 - u1)) in
+      r * cos (2 * pi * u2) : r * sin (2 * pi * u2) : go us
+    go _ = []
+
+-- the parts of a tessellation which are evaluated (the edges are lazy)
+summary :: Tessellation -> (IntMap Site, IntMap Tile, IntMap TileFacet)
+summary tess = (_sites tess, _tiles tess, _tilefacets tess)
+
+-- points copied in a C array
+newtype CPoints = CPoints (Ptr CDouble)
+
+instance NFData CPoints where
+  rnf (CPoints ptr) = ptr `seq` ()
+
+-- output of the C function, with its pointer to free it
+data COutput = COutput (Ptr CTessellation) CTessellation
+
+instance NFData COutput where
+  rnf (COutput ptr ctess) = ptr `seq` ctess `seq` ()
+
+cPoints :: [[Double]] -> IO CPoints
+cPoints points = CPoints <$> newArray (map realToFrac (concat points))
+
+freeCPoints :: CPoints -> IO ()
+freeCPoints (CPoints ptr) = free ptr
+
+-- frees the output of the C function, which is NULL if it failed
+freeCTessellation :: Int -> Ptr CTessellation -> IO ()
+freeCTessellation n result =
+  when (result /= nullPtr) $ c_freeTessellation result (fromIntegral n)
+
+-- output of the C function for points given by a list
+cOutput :: [[Double]] -> Int -> Int -> Bool -> IO COutput
+cOutput points dim n atinfinity = do
+  cpoints <- cPoints points
+  result <- cTessellation cpoints dim n atinfinity
+  freeCPoints cpoints
+  when (result == nullPtr) $ ioError (userError "tessellation failed")
+  COutput result <$> peek result
+
+cTessellation :: CPoints -> Int -> Int -> Bool -> IO (Ptr CTessellation)
+cTessellation (CPoints ptr) dim n atinfinity =
+  alloca $ \exitcodePtr ->
+    c_tessellation ptr (fromIntegral dim) (fromIntegral n) 0
+                   (fromIntegral $ fromEnum atinfinity) 0 0 nullPtr 1 nullPtr
+                   nullPtr exitcodePtr
+
+benchmarks :: Int -> Int -> (String, Int -> Int -> IO [[Double]], Bool)
+           -> Benchmark
+benchmarks dim n (_, distribution, atinfinity) =
+  env (force <$> distribution dim n) $ \points ->
+    bgroup ("n=" ++ show n)
+      [ bench "delaunay" $
+          nfIO (summary <$> delaunay points atinfinity False Nothing)
+      , envWithCleanup (cPoints points) freeCPoints $ \cpoints ->
+          bench "c_tessellation" $ whnfIO $
+            cTessellation cpoints dim n atinfinity >>= freeCTessellation n
+      , envWithCleanup (cOutput points dim n atinfinity)
+                       (\(COutput result _) -> freeCTessellation n result) $
+          \(COutput _ ctess) ->
+            bench "cTessellationToTessellation" $
+              nfIO (summary <$> cTessellationToTessellation points ctess)
+      , bgroup "options"
+        [ bench label $ nfIO (summary <$> delaunayWith opts' points)
+        | (label, opts) <- optionSets
+        , let opts' = opts { _atInfinity = atinfinity } ]
+      ]
+
+-- the qhull option sets compared in the "options" groups
+optionSets :: [(String, DelaunayOptions)]
+optionSets =
+  [ ("Qt Qx", defaultOptions { _premerge = ExactPremerge })
+  , ("Qt Q0", defaultOptions { _premerge = NoPremerge })
+  , ("QJ",    defaultOptions { _triangulation = Joggle Nothing })
+  , ("QE",    defaultOptions { _triangulation = Exact })
+  ]
+
+-- the C function for sites in 4-d to 6-d, where the hyperplanes of the new
+-- facets of qhull (qh_setfacetplane, counted by the statistic Zsetplane) take
+-- 15 to 30% of the time; this is the whole C function, the hyperplanes alone
+-- are timed by bench/qhull/setplane.c, with the kernel and the generic path
+setplaneBenchmarks :: Int -> Benchmark
+setplaneBenchmarks maxdim =
+  bgroup "setplane"
+    [ envWithCleanup (cPoints (cube dim n)) freeCPoints $ \cpoints ->
+        bench ("dim=" ++ show dim ++ "/n=" ++ show n) $ whnfIO $
+          cTessellation cpoints dim n False >>= freeCTessellation n
+    | (dim, n) <- [(4, 3000), (5, 800), (6, 300)], dim <= maxdim ]
+
+-- the largest number of points and the largest dimension are set by the
+-- environment variables DELAUNAY_BENCH_MAXN and DELAUNAY_BENCH_MAXDIM
+main :: IO ()
+main = do
+  maxn   <- maybe 1000 read <$> lookupEnv "DELAUNAY_BENCH_MAXN"
+  maxdim <- maybe 3 read <$> lookupEnv "DELAUNAY_BENCH_MAXDIM"
+  let sizes = takeWhile (<= maxn) [10^(k :: Int) | k <- [3 .. 6]]
+  defaultMain $
+    [ bgroup name
+      [ bgroup ("dim=" ++ show dim) [ benchmarks dim n d | n <- sizes ]
+      | dim <- [2 .. min 6 maxdim] ]
+    | d@(name, _, _) <- distributions ] ++ [ setplaneBenchmarks maxdim ]
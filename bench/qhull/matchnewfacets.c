@@ -0,0 +1,109 @@
+/* Time spent by qhull in qh_matchnewfacets, which matches the ridges of the
+   new facets, for the Delaunay triangulation ("qhull d Qt Qbb Qx") of a few
+   point sets, with the statistics of the matching.
+
+   It is built against the qhull of a checkout, so that two checkouts can be
+   compared (e.g. before and after the open-addressing table of the ridges):
+
+     cc -O2 -IC -o matchnewfacets bench/qhull/matchnewfacets.c \
+        $(find C -name '*_r.c' ! -name '*rbox*') -lm -lpthread \
+        -Wl,--wrap=qh_matchnewfacets
+     ./matchnewfacets [repetitions]
+
+   The option --wrap of the GNU linker routes the calls of qhull to
+   qh_matchnewfacets through the timer below; the best time of the
+   repetitions is reported. */
+
+#include "qhull_ra.h"
+#include <time.h>
+
+void __real_qh_matchnewfacets(qhT* qh);
+
+static double matchtime = 0;
+
+void __wrap_qh_matchnewfacets(qhT* qh){
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  __real_qh_matchnewfacets(qh);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  matchtime += (t1.tv_sec - t0.tv_sec) + 1e-9 * (t1.tv_nsec - t0.tv_nsec);
+}
+
+/* xorshift64 stream of uniform numbers in [0,1) */
+static unsigned long long seed = 88172645463325252ULL;
+static double uniform(void){
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+  return (seed >> 11) * (1.0 / 9007199254740992.0);
+}
+
+typedef struct Workload {
+  const char* name;
+  int         dim;
+  int         n;      /* number of points, k^dim for a grid */
+  int         kind;   /* 0 uniform in the cube, 1 rounded to 1/4, 2 grid */
+} WorkloadT;
+
+static coordT* points_(WorkloadT* w){
+  coordT* points = malloc(w->n * w->dim * sizeof(coordT));
+  if(w->kind == 2){
+    int k = (int)(pow(w->n, 1.0 / w->dim) + 0.5);
+    for(int i=0; i < w->n; i++){
+      int m = i;
+      for(int j=0; j < w->dim; j++){
+        points[i * w->dim + j] = m % k;
+        m /= k;
+      }
+    }
+  }else{
+    for(int i=0; i < w->n * w->dim; i++){
+      points[i] = w->kind == 1 ? floor(uniform() * 4) / 4 : uniform();
+    }
+  }
+  return points;
+}
+
+int main(int argc, char** argv){
+  WorkloadT workloads[] = {
+    {"4-d grid 6^4",        4, 1296, 2},
+    {"5-d 1000 rounded",    5, 1000, 1},
+    {"5-d 3000 uniform",    5, 3000, 0},
+    {"6-d 1500 uniform",    6, 1500, 0},
+    {"7-d 300 uniform",     7,  300, 0}
+  };
+  int repetitions = argc > 1 ? atoi(argv[1]) : 1;
+  printf("%-20s %10s %10s %12s %12s\n", "points", "facets", "time (s)",
+         "lookups", "tests");
+  for(unsigned w=0; w < sizeof(workloads) / sizeof(WorkloadT); w++){
+    coordT* points = points_(&workloads[w]);
+    double best = -1;
+    int nfacets = 0, lookups = 0, tests = 0;
+    for(int r=0; r < repetitions; r++){
+      qhT qh_qh;
+      qhT* qh = &qh_qh;
+      int curlong, totlong;
+      qh_zero(qh, stderr);
+      matchtime = 0;
+      int exitcode = qh_new_qhull(qh, workloads[w].dim, workloads[w].n,
+                                  points, False, "qhull d Qt Qbb Qx", NULL,
+                                  stderr);
+      if(exitcode){
+        fprintf(stderr, "%s: qhull error %d\n", workloads[w].name, exitcode);
+        return 1;
+      }
+      if(best < 0 || matchtime < best){
+        best = matchtime;
+      }
+      nfacets = qh->num_facets;
+      lookups = zval_(Zhashlookup);
+      tests   = zval_(Zhashtests);
+      qh_freeqhull(qh, !qh_ALL);
+      qh_memfreeshort(qh, &curlong, &totlong);
+    }
+    printf("%-20s %10d %10.3f %12d %12d\n", workloads[w].name, nfacets, best,
+           lookups, tests);
+    free(points);
+  }
+  return 0;
+}
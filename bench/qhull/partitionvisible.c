@@ -0,0 +1,132 @@
+/* Time of qhull with several threads for the re-partition of the outside
+   points of the visible facets (qh_partitionbatch), for the Delaunay
+   triangulation ("qhull d Qt Qbb Qx") of uniform points rounded to a few
+   values, whose many merges make qhull search all the new facets for these
+   points (qh.findbestnew); on points in general position, qh_findbest is
+   used instead and the threads are not started.
+
+     cc -O2 -IC -o partitionvisible bench/qhull/partitionvisible.c \
+        $(find C -name '*_r.c' ! -name '*rbox*') -lm -lpthread
+     ./partitionvisible [repetitions [threads ...]]
+
+   The best time of the repetitions is reported, with the number of batched
+   re-partitions (Zpartbatch) and of points replayed from their scans
+   (Zfindnewbatch); the triangulation must be the same for all thread
+   counts, which is checked with a hash of its facets. */
+
+#include "qhull_ra.h"
+#include <time.h>
+
+/* xorshift64 stream of uniform numbers in [0,1) */
+static unsigned long long seed = 88172645463325252ULL;
+static double uniform(void){
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+  return (seed >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double now_(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+typedef struct Workload {
+  const char* name;
+  int         dim;
+  int         n;
+  int         levels; /* the coordinates are rounded to 1/levels */
+} WorkloadT;
+
+typedef struct Run {
+  double             time;
+  int                batches;
+  int                replayed;
+  unsigned long long hash;
+} RunT;
+
+/* runs qhull as tessellation() in C/delaunay.c does, with nthreads threads */
+static int run_(WorkloadT* w, coordT* points, int nthreads, RunT* run){
+  qhT qh_qh;
+  qhT* qh = &qh_qh;
+  int curlong, totlong, exitcode;
+  facetT* facet;
+  vertexT *vertex, **vertexp;
+  qh_zero(qh, stderr);
+  qh_meminit(qh, stderr);
+  qh_initqhull_start(qh, NULL, NULL, stderr);
+  qh->NUMthreads = nthreads;
+  double t = now_();
+  exitcode = setjmp(qh->errexit);
+  if(!exitcode){
+    qh->NOerrexit = False;
+    qh_initflags(qh, "qhull d Qt Qbb Qx");
+    qh->PROJECTdelaunay = True;
+    qh_init_B(qh, points, w->n, w->dim, False);
+    qh_qhull(qh);
+    run->time = now_() - t;
+    run->batches  = zval_(Zpartbatch);
+    run->replayed = zval_(Zfindnewbatch);
+    run->hash = 0;
+    FORALLfacets{
+      if(!facet->upperdelaunay){
+        FOREACHvertex_(facet->vertices){
+          run->hash = run->hash * 1000003 + qh_pointid(qh, vertex->point);
+        }
+      }
+    }
+  }
+  qh->NOerrexit = True;
+  qh_freeqhull(qh, !qh_ALL);
+  qh_memfreeshort(qh, &curlong, &totlong);
+  return exitcode;
+}
+
+int main(int argc, char** argv){
+  WorkloadT workloads[] = {
+    {"3-d 10^5 rounded 1/6",  3, 100000,  6},
+    {"3-d 10^5 rounded 1/10", 3, 100000, 10},
+    {"4-d 10^5 rounded 1/4",  4, 100000,  4}
+  };
+  int threads[16] = {1, 2, 4}, nthreads = 3;
+  int repetitions = argc > 1 ? atoi(argv[1]) : 1;
+  if(argc > 2){
+    nthreads = 0;
+    for(int i=2; i < argc && nthreads < 16; i++){
+      threads[nthreads++] = atoi(argv[i]);
+    }
+  }
+  printf("%-22s %8s %10s %10s %10s %s\n", "points", "threads", "time (s)",
+         "batches", "replayed", "same output");
+  for(unsigned w=0; w < sizeof(workloads) / sizeof(WorkloadT); w++){
+    WorkloadT* workload = &workloads[w];
+    coordT* points = malloc(workload->n * workload->dim * sizeof(coordT));
+    unsigned long long hash = 0;
+    for(int t=0; t < nthreads; t++){
+      RunT best = {-1, 0, 0, 0}, run;
+      for(int r=0; r < repetitions; r++){
+        /* qhull scales the points in place (Qbb) */
+        seed = 88172645463325252ULL + w;
+        for(int i=0; i < workload->n * workload->dim; i++){
+          points[i] = floor(uniform() * workload->levels) / workload->levels;
+        }
+        if(run_(workload, points, threads[t], &run)){
+          fprintf(stderr, "%s: qhull error\n", workload->name);
+          return 1;
+        }
+        if(best.time < 0 || run.time < best.time){
+          best = run;
+        }
+      }
+      if(t == 0){
+        hash = best.hash;
+      }
+      printf("%-22s %8d %10.3f %10d %10d %s\n", workload->name, threads[t],
+             best.time, best.batches, best.replayed,
+             best.hash == hash ? "yes" : "no");
+    }
+    free(points);
+  }
+  return 0;
+}
@@ -0,0 +1,144 @@
+/* Time of the hyperplanes of the simplicial facets of qhull (qh_setfacetplane,
+   counted by the statistic Zsetplane), computed by the kernel of each
+   dimension of the hull (qh_sethyperplane_simplex, 5-d to 7-d) and by the
+   generic path (the vertices copied to qh.gm_matrix for
+   qh_sethyperplane_gauss), on the facets of the Delaunay triangulation
+   ("qhull d Qt Qbb Qx") of uniform points in 4-d to 6-d; the two hyperplanes
+   of each facet are compared.
+
+     cc -O2 -IC -o setplane bench/qhull/setplane.c \
+        $(find C -name '*_r.c' ! -name '*rbox*') -lm -lpthread
+     ./setplane [repetitions]
+
+   The best time of the repetitions is reported, in nanoseconds per facet;
+   with qh_SIMPLEXplane 0 in C/user_r.h, the kernel always declines. */
+
+#include "qhull_ra.h"
+#include <string.h>
+#include <time.h>
+
+/* xorshift64 stream of uniform numbers in [0,1) */
+static unsigned long long seed = 88172645463325252ULL;
+static double uniform(void){
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+  return (seed >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double now_(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+/* the generic path of qh_setfacetplane in 5-d and more */
+static void generic_(qhT* qh, facetT* facet){
+  pointT* point0 = SETfirstt_(facet->vertices, vertexT)->point;
+  vertexT *vertex, **vertexp;
+  coordT* gmcoord = qh->gm_matrix;
+  boolT nearzero;
+  int i = 0;
+  FOREACHvertex_(facet->vertices){
+    if(vertex->point != point0){
+      qh->gm_row[i++] = gmcoord;
+      for(int k=0; k < qh->hull_dim; k++){
+        *(gmcoord++) = vertex->point[k] - point0[k];
+      }
+    }
+  }
+  qh->gm_row[i] = gmcoord;
+  qh_sethyperplane_gauss(qh, qh->hull_dim, qh->gm_row, point0,
+                         facet->toporient, facet->normal, &facet->offset,
+                         &nearzero);
+}
+
+/* the kernel; returns 0 if it declines (near zero pivot or norm) */
+static int kernel_(qhT* qh, facetT* facet){
+  pointT* point0 = SETfirstt_(facet->vertices, vertexT)->point;
+  return qh_sethyperplane_simplex(qh, facet, point0);
+}
+
+int main(int argc, char** argv){
+  int workloads[][2] = {{4, 3000}, {5, 800}, {6, 300}};
+  int repetitions = argc > 1 ? atoi(argv[1]) : 5;
+  printf("%-6s %8s %10s %12s %12s %8s %9s %9s\n", "sites", "n", "facets",
+         "generic (ns)", "kernel (ns)", "speedup", "declined", "different");
+  for(unsigned w=0; w < sizeof(workloads) / sizeof(workloads[0]); w++){
+    int dim = workloads[w][0], n = workloads[w][1];
+    coordT* points = malloc(n * dim * sizeof(coordT));
+    for(int i=0; i < n * dim; i++){
+      points[i] = uniform();
+    }
+    qhT qh_qh;
+    qhT* qh = &qh_qh;
+    int curlong, totlong;
+    qh_zero(qh, stderr);
+    if(qh_new_qhull(qh, dim, n, points, False, "qhull d Qt Qbb Qx", NULL,
+                    stderr))
+    {
+      fprintf(stderr, "%d-d: qhull error\n", dim);
+      return 1;
+    }
+    int hulldim = qh->hull_dim, nfacets = 0;
+    facetT** facets = malloc(qh->num_facets * sizeof(facetT*));
+    facetT* facet;
+    FORALLfacets{
+      if(facet->simplicial && !facet->tricoplanar){
+        facets[nfacets++] = facet;
+      }
+    }
+    /* the hyperplanes by the two paths */
+    size_t size = (hulldim + 1) * sizeof(double);
+    double* generic = malloc(nfacets * size);
+    double* kernel  = malloc(nfacets * size);
+    int declined = 0, different = 0;
+    for(int f=0; f < nfacets; f++){
+      generic_(qh, facets[f]);
+      memcpy(generic + f * (hulldim + 1), facets[f]->normal,
+             hulldim * sizeof(double));
+      generic[f * (hulldim + 1) + hulldim] = facets[f]->offset;
+      if(!kernel_(qh, facets[f])){
+        declined++;
+        generic_(qh, facets[f]);
+      }
+      memcpy(kernel + f * (hulldim + 1), facets[f]->normal,
+             hulldim * sizeof(double));
+      kernel[f * (hulldim + 1) + hulldim] = facets[f]->offset;
+      if(memcmp(generic + f * (hulldim + 1), kernel + f * (hulldim + 1),
+                size))
+      {
+        different++;
+      }
+    }
+    double tgeneric = -1, tkernel = -1;
+    for(int r=0; r < repetitions; r++){
+      double t = now_();
+      for(int f=0; f < nfacets; f++){
+        generic_(qh, facets[f]);
+      }
+      t = now_() - t;
+      if(tgeneric < 0 || t < tgeneric){
+        tgeneric = t;
+      }
+      t = now_();
+      for(int f=0; f < nfacets; f++){
+        kernel_(qh, facets[f]);
+      }
+      t = now_() - t;
+      if(tkernel < 0 || t < tkernel){
+        tkernel = t;
+      }
+    }
+    printf("%-6d %8d %10d %12.1f %12.1f %8.2f %9d %9d\n", dim, n, nfacets,
+           1e9 * tgeneric / nfacets, 1e9 * tkernel / nfacets,
+           tgeneric / tkernel, declined, different);
+    free(generic);
+    free(kernel);
+    free(facets);
+    qh_freeqhull(qh, !qh_ALL);
+    qh_memfreeshort(qh, &curlong, &totlong);
+    free(points);
+  }
+  return 0;
+}
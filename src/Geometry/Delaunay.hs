@@ -10,7 +10,9 @@ See README for an example.
 module Geometry.Delaunay
   (module X)
   where
+import           Geometry.Delaunay.Compact  as X
 import           Geometry.Delaunay.Delaunay as X
+import           Geometry.Delaunay.Rbox     as X
 import           Geometry.Delaunay.Types    as X
 import           Geometry.Qhull.Shared      as X
 import           Geometry.Qhull.Types       as X
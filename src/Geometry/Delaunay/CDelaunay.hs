@@ -1,28 +1,65 @@
 -- {-# LINE 1 "delaunay.hsc" #-}
 {-# LANGUAGE ForeignFunctionInterface #-}
+{-# LANGUAGE RankNTypes #-}
+{-|
+Module      : Geometry.Delaunay.CDelaunay
+Description : Bindings to the C code.
+
+Low-level bindings to the C function performing the tessellation, and the
+conversion of its output. This module is exposed for the benchmarks and it
+is not part of the stable interface.
+-}
 module Geometry.Delaunay.CDelaunay
   ( 
-    cTessellationToTessellation
+    CTessellation
+  , CProgress(..)
+  , CStats
+  , cStatsToStats
+  , cancelProgress
+  , cancelledExitCode
+  , cTessellationToTessellation
+  , cTessellationToTessellationWith
   , c_tessellation 
+  , c_tessellation_safe
+  , c_freeTessellation
+  , c_estimatememory
+  , c_mempoolrelease
+  , sitesToEdges
   )
   where
-import           Control.Monad              ( (<$!>) )
+import           Control.Concurrent         ( getNumCapabilities )
+import           Control.Concurrent.Async   ( forConcurrently )
+import           Control.DeepSeq            ( NFData, force )
+import           Control.Exception          ( evaluate )
+import           Control.Monad              ( (<$!>), (>=>) )
 import qualified Data.HashMap.Strict.InsOrd as H
-import           Data.IntMap.Strict         ( fromAscList, (!) )
+import           Data.IntMap.Strict         ( fromAscList,
+                                              fromDistinctAscList,
+                                              toAscList,
+                                              (!) )
 import qualified Data.IntSet                as IS
-import           Data.List                  ( findIndex )
-import           Data.Maybe                 ( fromJust, isJust )
-import           Data.Tuple.Extra           ( both, fst3, snd3, thd3, (&&&) )
+import           Data.Vector                ( Vector )
+import qualified Data.Vector                as V
 import           Geometry.Delaunay.Types    ( Tessellation(..),
                                               Tile(..),
                                               TileFacet(..),
                                               Simplex(..),
-                                              Site(..) )
+                                              Site(..),
+                                              Stats(..) )
+import           Geometry.Delaunay.Trace    ( traced )
 import           Foreign  ( Ptr,
                             Storable(pokeByteOff, poke, peek, alignment, sizeOf, peekByteOff),
+                            advancePtr,
                             peekArray )
-import           Foreign.C.Types            ( CInt, CDouble(..), CUInt(..) )
-import           Geometry.Qhull.Types       ( Family(Family, None), IndexPair(Pair) )
+import           Foreign.C.String           ( CString )
+import           Foreign.C.Types            ( CInt,
+                                              CDouble(..),
+                                              CSize(..),
+                                              CUInt(..) )
+import           Geometry.Qhull.Types       ( Family(Family, None),
+                                              IndexPair(Pair),
+                                              IndexMap,
+                                              EdgeMap )
 
 data CSite = CSite {
     __id             :: CUInt
@@ -79,13 +116,13 @@ instance Storable CSite where
           (\hsc_ptr -> pokeByteOff hsc_ptr 48) ptr r7
 -- {-# LINE 55 "delaunay.hsc" #-}
 
-cSiteToSite :: [[Double]] -> CSite -> IO (Int, Site, [(Int,Int)])
+cSiteToSite :: Vector [Double] -> CSite -> IO (Int, Site)
 cSiteToSite sites csite = do
   let id'          = fromIntegral $ __id csite
       nneighsites  = fromIntegral $ __nneighsites csite
       nneighridges = fromIntegral $ __nneighridges csite
       nneightiles  = fromIntegral $ __nneightiles csite
-      point        = sites !! id'
+      point        = sites V.! id'
   neighsites <- (<$!>) (map fromIntegral)
                        (peekArray nneighsites (__neighsites csite))
   neighridges <- (<$!>) (map fromIntegral)
@@ -98,15 +135,16 @@ cSiteToSite sites csite = do
                 , _neighsitesIds  = IS.fromAscList neighsites
                 , _neighfacetsIds = IS.fromAscList neighridges
                 , _neightilesIds  = IS.fromAscList neightiles
-                }
-         , map (\j -> (id', j)) (filterAscList id' neighsites) )
+                } )
+
+-- | the edges, derived from the neighbor sites of each site; an edge (i,j)
+-- is recorded once, at the site i < j
+sitesToEdges :: IndexMap Site -> EdgeMap
+sitesToEdges sites = H.fromList (concatMap siteEdges (toAscList sites))
   where
-    filterAscList :: Int -> [Int] -> [Int]
-    filterAscList n list =
-      let i = findIndex (> n) list in
-      if isJust i
-        then drop (fromJust i) list
-        else []
+    siteEdges (i, site) =
+      map (\j -> (Pair i j, (_point site, _point (sites ! j))))
+          (IS.toAscList (snd (IS.split i (_neighsitesIds site))))
 
 data CSimplex = CSimplex {
     __sitesids :: Ptr CUInt
@@ -145,23 +183,30 @@ instance Storable CSimplex where
           (\hsc_ptr -> pokeByteOff hsc_ptr 24) ptr r4
 -- {-# LINE 102 "delaunay.hsc" #-}
 
-cSimplexToSimplex :: [[Double]] -> Int -> CSimplex -> IO Simplex
+cSimplexToSimplex :: Vector [Double] -> Int -> CSimplex -> IO Simplex
 cSimplexToSimplex sites simplexdim csimplex = do
-  let radius      = cdbl2dbl $ __radius csimplex
-      volume      = cdbl2dbl $ __volume csimplex
-      dim         = length (head sites)
+  let dim = length (V.head sites)
+  center <- (<$!>) (map cdbl2dbl) (peekArray dim (__center csimplex))
+  cSimplexToSimplexWith sites simplexdim csimplex
+                        (center, cdbl2dbl $ __radius csimplex)
+
+-- the same with the given circumcenter and circumradius, those of the family
+-- of a tile
+cSimplexToSimplexWith :: Vector [Double] -> Int -> CSimplex
+                      -> ([Double], Double) -> IO Simplex
+cSimplexToSimplexWith sites simplexdim csimplex (center, radius) = do
+  let volume      = cdbl2dbl $ __volume csimplex
   sitesids <- (<$!>) (map fromIntegral)
                      (peekArray simplexdim (__sitesids csimplex))
   let points = fromAscList
-               (zip sitesids (map ((!!) sites) sitesids))
-  center <- (<$!>) (map cdbl2dbl) (peekArray dim (__center csimplex))
+               (zip sitesids (map (sites V.!) sitesids))
   return Simplex { _vertices'       = points
                  , _circumcenter = center
                  , _circumradius = radius
                  , _volume'       = volume }
-  where
-    cdbl2dbl :: CDouble -> Double
-    cdbl2dbl x = if isNaN x then 0/0 else realToFrac x
+
+cdbl2dbl :: CDouble -> Double
+cdbl2dbl x = if isNaN x then 0/0 else realToFrac x
 
 data CSubTile = CSubTile {
     __id'        :: CUInt
@@ -211,9 +256,9 @@ instance Storable CSubTile where
           (\hsc_ptr -> pokeByteOff hsc_ptr 56) ptr r6
 -- {-# LINE 154 "delaunay.hsc" #-}
 
-cSubTiletoTileFacet :: [[Double]] -> CSubTile -> IO (Int, TileFacet)
+cSubTiletoTileFacet :: Vector [Double] -> CSubTile -> IO (Int, TileFacet)
 cSubTiletoTileFacet points csubtile = do
-  let dim        = length (head points)
+  let dim        = length (V.head points)
       ridgeOf1   = fromIntegral $ __ridgeOf1 csubtile
       ridgeOf2   = fromIntegral $ __ridgeOf2 csubtile
       ridgeOf    = if ridgeOf2 == -1 then [ridgeOf1] else [ridgeOf1, ridgeOf2]
@@ -288,16 +333,21 @@ instance Storable CTile where
           (\hsc_ptr -> pokeByteOff hsc_ptr 72) ptr r8
 -- {-# LINE 213 "delaunay.hsc" #-}
 
-cTileToTile :: [[Double]] -> CTile -> IO (Int, Tile)
-cTileToTile points ctile = do
+-- the circumspheres of the families are shared by their tiles
+cTileToTile :: Vector [Double] -> Vector ([Double], Double) -> CTile
+            -> IO (Int, Tile)
+cTileToTile points families ctile = do
   let id'        = fromIntegral $ __id'' ctile
       csimplex   = __simplex ctile
       nneighbors = fromIntegral $ __nneighbors ctile
       nridges    = fromIntegral $ __nridges ctile
       family     = __family ctile
       orient     = __orientation ctile
-      dim        = length (head points)
-  simplex <- cSimplexToSimplex points (dim+1) csimplex
+      dim        = length (V.head points)
+  simplex <- if family == -1
+    then cSimplexToSimplex points (dim+1) csimplex
+    else cSimplexToSimplexWith points (dim+1) csimplex
+                               (families V.! fromIntegral family)
   neighbors <- (<$!>) (map fromIntegral)
                       (peekArray nneighbors (__neighbors ctile))
   ridgesids <- (<$!>) (map fromIntegral)
@@ -310,16 +360,46 @@ cTileToTile points ctile = do
                                         else Family (fromIntegral family)
                      , _toporiented  = orient == 1 })
 
+data CFamily = CFamily {
+    __owner        :: CUInt
+  , __familycenter :: Ptr CDouble
+  , __familyradius :: CDouble
+}
+
+instance Storable CFamily where
+    sizeOf    __ = (24)
+    alignment __ = 8
+    peek ptr = do
+      owner'  <- (\hsc_ptr -> peekByteOff hsc_ptr 0) ptr
+      center' <- (\hsc_ptr -> peekByteOff hsc_ptr 8) ptr
+      radius' <- (\hsc_ptr -> peekByteOff hsc_ptr 16) ptr
+      return CFamily { __owner        = owner'
+                     , __familycenter = center'
+                     , __familyradius = radius'
+                    }
+    poke ptr (CFamily r1 r2 r3)
+      = do
+          (\hsc_ptr -> pokeByteOff hsc_ptr 0) ptr r1
+          (\hsc_ptr -> pokeByteOff hsc_ptr 8) ptr r2
+          (\hsc_ptr -> pokeByteOff hsc_ptr 16) ptr r3
+
+cFamilyToCircumsphere :: Int -> CFamily -> IO ([Double], Double)
+cFamilyToCircumsphere dim cfamily = do
+  center <- (<$!>) (map cdbl2dbl) (peekArray dim (__familycenter cfamily))
+  return (center, cdbl2dbl $ __familyradius cfamily)
+
 data CTessellation = CTessellation {
     __sites     :: Ptr CSite
   , __tiles     :: Ptr CTile
   , __ntiles    :: CUInt
   , __subtiles  :: Ptr CSubTile
   , __nsubtiles :: CUInt
+  , __families  :: Ptr CFamily
+  , __nfamilies :: CUInt
 }
 
 instance Storable CTessellation where
-    sizeOf    __ = (40)
+    sizeOf    __ = (56)
 -- {-# LINE 246 "delaunay.hsc" #-}
     alignment __ = 8
 -- {-# LINE 247 "delaunay.hsc" #-}
@@ -334,14 +414,18 @@ instance Storable CTessellation where
 -- {-# LINE 252 "delaunay.hsc" #-}
       nsubtiles' <- (\hsc_ptr -> peekByteOff hsc_ptr 32) ptr
 -- {-# LINE 253 "delaunay.hsc" #-}
+      families'  <- (\hsc_ptr -> peekByteOff hsc_ptr 40) ptr
+      nfamilies' <- (\hsc_ptr -> peekByteOff hsc_ptr 48) ptr
       return CTessellation {
                      __sites     = sites'
                    , __tiles     = tiles'
                    , __ntiles    = ntiles'
                    , __subtiles  = subtiles'
                    , __nsubtiles = nsubtiles'
+                   , __families  = families'
+                   , __nfamilies = nfamilies'
                   }
-    poke ptr (CTessellation r1 r2 r3 r4 r5)
+    poke ptr (CTessellation r1 r2 r3 r4 r5 r6 r7)
       = do
           (\hsc_ptr -> pokeByteOff hsc_ptr 0) ptr r1
 -- {-# LINE 263 "delaunay.hsc" #-}
@@ -353,35 +437,291 @@ instance Storable CTessellation where
 -- {-# LINE 266 "delaunay.hsc" #-}
           (\hsc_ptr -> pokeByteOff hsc_ptr 32) ptr r5
 -- {-# LINE 267 "delaunay.hsc" #-}
+          (\hsc_ptr -> pokeByteOff hsc_ptr 40) ptr r6
+          (\hsc_ptr -> pokeByteOff hsc_ptr 48) ptr r7
+
+data CProgress = CProgress {
+    __cancel     :: CInt
+  , __phase      :: CInt
+  , __npoints    :: CUInt
+  , __nprocessed :: CUInt
+  , __nfacets    :: CUInt
+  , __ntiles     :: CUInt
+  , __ndone      :: CUInt
+}
+
+instance Storable CProgress where
+    sizeOf    __ = (28)
+    alignment __ = 4
+    peek ptr = do
+      cancel'     <- (\hsc_ptr -> peekByteOff hsc_ptr 0) ptr
+      phase'      <- (\hsc_ptr -> peekByteOff hsc_ptr 4) ptr
+      npoints'    <- (\hsc_ptr -> peekByteOff hsc_ptr 8) ptr
+      nprocessed' <- (\hsc_ptr -> peekByteOff hsc_ptr 12) ptr
+      nfacets'    <- (\hsc_ptr -> peekByteOff hsc_ptr 16) ptr
+      ntiles'     <- (\hsc_ptr -> peekByteOff hsc_ptr 20) ptr
+      ndone'      <- (\hsc_ptr -> peekByteOff hsc_ptr 24) ptr
+      return CProgress { __cancel     = cancel'
+                       , __phase      = phase'
+                       , __npoints    = npoints'
+                       , __nprocessed = nprocessed'
+                       , __nfacets    = nfacets'
+                       , __ntiles     = ntiles'
+                       , __ndone      = ndone'
+                      }
+    poke ptr (CProgress r1 r2 r3 r4 r5 r6 r7)
+      = do
+          (\hsc_ptr -> pokeByteOff hsc_ptr 0) ptr r1
+          (\hsc_ptr -> pokeByteOff hsc_ptr 4) ptr r2
+          (\hsc_ptr -> pokeByteOff hsc_ptr 8) ptr r3
+          (\hsc_ptr -> pokeByteOff hsc_ptr 12) ptr r4
+          (\hsc_ptr -> pokeByteOff hsc_ptr 16) ptr r5
+          (\hsc_ptr -> pokeByteOff hsc_ptr 20) ptr r6
+          (\hsc_ptr -> pokeByteOff hsc_ptr 24) ptr r7
+
+data CStats = CStats {
+    __stbuild       :: CDouble
+  , __sttriangulate :: CDouble
+  , __sttiles       :: CDouble
+  , __stsites       :: CDouble
+  , __stridges      :: CDouble
+  , __sttotal       :: CDouble
+  , __snpartitions  :: CUInt
+  , __snvisible     :: CUInt
+  , __snmerges      :: CUInt
+  , __snretries     :: CUInt
+  , __snfacets      :: CUInt
+  , __snvertices    :: CUInt
+  , __sntiles       :: CUInt
+  , __snridges      :: CUInt
+  , __stotshort     :: CInt
+  , __stotlong      :: CInt
+  , __smaxlong      :: CInt
+  , __stotbuffer    :: CInt
+  , __sallocs       :: CUInt
+  , __stotallocs    :: CUInt
+  , __sbytes        :: CSize
+  , __speakbytes    :: CSize
+  , __speak         :: CSize
+  , __sjoggle       :: CDouble
+}
+
+instance Storable CStats where
+    sizeOf    __ = (136)
+    alignment __ = 8
+    peek ptr = do
+      tbuild'       <- (\hsc_ptr -> peekByteOff hsc_ptr 0) ptr
+      ttriangulate' <- (\hsc_ptr -> peekByteOff hsc_ptr 8) ptr
+      ttiles'       <- (\hsc_ptr -> peekByteOff hsc_ptr 16) ptr
+      tsites'       <- (\hsc_ptr -> peekByteOff hsc_ptr 24) ptr
+      tridges'      <- (\hsc_ptr -> peekByteOff hsc_ptr 32) ptr
+      ttotal'       <- (\hsc_ptr -> peekByteOff hsc_ptr 40) ptr
+      npartitions'  <- (\hsc_ptr -> peekByteOff hsc_ptr 48) ptr
+      nvisible'     <- (\hsc_ptr -> peekByteOff hsc_ptr 52) ptr
+      nmerges'      <- (\hsc_ptr -> peekByteOff hsc_ptr 56) ptr
+      nretries'     <- (\hsc_ptr -> peekByteOff hsc_ptr 60) ptr
+      nfacets'      <- (\hsc_ptr -> peekByteOff hsc_ptr 64) ptr
+      nvertices'    <- (\hsc_ptr -> peekByteOff hsc_ptr 68) ptr
+      ntiles'       <- (\hsc_ptr -> peekByteOff hsc_ptr 72) ptr
+      nridges'      <- (\hsc_ptr -> peekByteOff hsc_ptr 76) ptr
+      totshort'     <- (\hsc_ptr -> peekByteOff hsc_ptr 80) ptr
+      totlong'      <- (\hsc_ptr -> peekByteOff hsc_ptr 84) ptr
+      maxlong'      <- (\hsc_ptr -> peekByteOff hsc_ptr 88) ptr
+      totbuffer'    <- (\hsc_ptr -> peekByteOff hsc_ptr 92) ptr
+      allocs'       <- (\hsc_ptr -> peekByteOff hsc_ptr 96) ptr
+      totallocs'    <- (\hsc_ptr -> peekByteOff hsc_ptr 100) ptr
+      bytes'        <- (\hsc_ptr -> peekByteOff hsc_ptr 104) ptr
+      peakbytes'    <- (\hsc_ptr -> peekByteOff hsc_ptr 112) ptr
+      peak'         <- (\hsc_ptr -> peekByteOff hsc_ptr 120) ptr
+      joggle'       <- (\hsc_ptr -> peekByteOff hsc_ptr 128) ptr
+      return CStats { __stbuild       = tbuild'
+                    , __sttriangulate = ttriangulate'
+                    , __sttiles       = ttiles'
+                    , __stsites       = tsites'
+                    , __stridges      = tridges'
+                    , __sttotal       = ttotal'
+                    , __snpartitions  = npartitions'
+                    , __snvisible     = nvisible'
+                    , __snmerges      = nmerges'
+                    , __snretries     = nretries'
+                    , __snfacets      = nfacets'
+                    , __snvertices    = nvertices'
+                    , __sntiles       = ntiles'
+                    , __snridges      = nridges'
+                    , __stotshort     = totshort'
+                    , __stotlong      = totlong'
+                    , __smaxlong      = maxlong'
+                    , __stotbuffer    = totbuffer'
+                    , __sallocs       = allocs'
+                    , __stotallocs    = totallocs'
+                    , __sbytes        = bytes'
+                    , __speakbytes    = peakbytes'
+                    , __speak         = peak'
+                    , __sjoggle       = joggle'
+                    }
+    poke ptr (CStats r1 r2 r3 r4 r5 r6 r7 r8 r9 r10 r11 r12
+                     r13 r14 r15 r16 r17 r18 r19 r20 r21 r22 r23 r24)
+      = do
+          (\hsc_ptr -> pokeByteOff hsc_ptr 0) ptr r1
+          (\hsc_ptr -> pokeByteOff hsc_ptr 8) ptr r2
+          (\hsc_ptr -> pokeByteOff hsc_ptr 16) ptr r3
+          (\hsc_ptr -> pokeByteOff hsc_ptr 24) ptr r4
+          (\hsc_ptr -> pokeByteOff hsc_ptr 32) ptr r5
+          (\hsc_ptr -> pokeByteOff hsc_ptr 40) ptr r6
+          (\hsc_ptr -> pokeByteOff hsc_ptr 48) ptr r7
+          (\hsc_ptr -> pokeByteOff hsc_ptr 52) ptr r8
+          (\hsc_ptr -> pokeByteOff hsc_ptr 56) ptr r9
+          (\hsc_ptr -> pokeByteOff hsc_ptr 60) ptr r10
+          (\hsc_ptr -> pokeByteOff hsc_ptr 64) ptr r11
+          (\hsc_ptr -> pokeByteOff hsc_ptr 68) ptr r12
+          (\hsc_ptr -> pokeByteOff hsc_ptr 72) ptr r13
+          (\hsc_ptr -> pokeByteOff hsc_ptr 76) ptr r14
+          (\hsc_ptr -> pokeByteOff hsc_ptr 80) ptr r15
+          (\hsc_ptr -> pokeByteOff hsc_ptr 84) ptr r16
+          (\hsc_ptr -> pokeByteOff hsc_ptr 88) ptr r17
+          (\hsc_ptr -> pokeByteOff hsc_ptr 92) ptr r18
+          (\hsc_ptr -> pokeByteOff hsc_ptr 96) ptr r19
+          (\hsc_ptr -> pokeByteOff hsc_ptr 100) ptr r20
+          (\hsc_ptr -> pokeByteOff hsc_ptr 104) ptr r21
+          (\hsc_ptr -> pokeByteOff hsc_ptr 112) ptr r22
+          (\hsc_ptr -> pokeByteOff hsc_ptr 120) ptr r23
+          (\hsc_ptr -> pokeByteOff hsc_ptr 128) ptr r24
+
+-- | statistics of a tessellation, from the structure filled by the C code
+cStatsToStats :: CStats -> Stats
+cStatsToStats cstats = Stats
+  { _buildTime         = realToFrac $ __stbuild cstats
+  , _triangulationTime = realToFrac $ __sttriangulate cstats
+  , _tilesTime         = realToFrac $ __sttiles cstats
+  , _sitesTime         = realToFrac $ __stsites cstats
+  , _ridgesTime        = realToFrac $ __stridges cstats
+  , _cTime             = realToFrac $ __sttotal cstats
+  , _conversionTime    = 0
+  , _npartitions       = fromIntegral $ __snpartitions cstats
+  , _nvisible          = fromIntegral $ __snvisible cstats
+  , _nmerges           = fromIntegral $ __snmerges cstats
+  , _nretries          = fromIntegral $ __snretries cstats
+  , _nhullFacets       = fromIntegral $ __snfacets cstats
+  , _nhullVertices     = fromIntegral $ __snvertices cstats
+  , _ntessTiles        = fromIntegral $ __sntiles cstats
+  , _ntessRidges       = fromIntegral $ __snridges cstats
+  , _shortMemory       = fromIntegral $ __stotshort cstats
+  , _longMemory        = fromIntegral $ __stotlong cstats
+  , _maxLongMemory     = fromIntegral $ __smaxlong cstats
+  , _bufferMemory      = fromIntegral $ __stotbuffer cstats
+  , _allocations       = fromIntegral $ __sallocs cstats
+  , _totalAllocations  = fromIntegral $ __stotallocs cstats
+  , _outputMemory      = fromIntegral $ __sbytes cstats
+  , _peakOutputMemory  = fromIntegral $ __speakbytes cstats
+  , _peakMemory        = fromIntegral $ __speak cstats
+  , _joggle            = realToFrac $ __sjoggle cstats
+  }
+
+-- | asks the C code to stop the tessellation reporting to this structure
+cancelProgress :: Ptr CProgress -> IO ()
+cancelProgress ptr = (\hsc_ptr -> pokeByteOff hsc_ptr 0) ptr (1 :: CInt)
+
+-- | exit code of a cancelled tessellation (qh_ERRcancel)
+cancelledExitCode :: CUInt
+cancelledExitCode = 6
 
 foreign import ccall unsafe "tessellation" c_tessellation
-  :: Ptr CDouble -- sites
-  -> CUInt       -- dim
-  -> CUInt       -- nsites
-  -> CUInt       -- 0/1, point at infinity
-  -> CUInt       -- 0/1, include degenerate
-  -> CDouble     -- volume threshold
-  -> Ptr CUInt   -- exitcode
+  :: Ptr CDouble   -- sites
+  -> CUInt         -- dim
+  -> CUInt         -- nsites
+  -> CUInt         -- 0/1, sites in rows of dim+1 coordinates, lifted in place
+  -> CUInt         -- 0/1, point at infinity
+  -> CUInt         -- 0/1, include degenerate
+  -> CDouble       -- volume threshold
+  -> CString       -- qhull options, or NULL for the default ones
+  -> CUInt         -- number of threads re-partitioning the sites
+  -> Ptr CProgress -- progress report and cancellation, or NULL
+  -> Ptr CStats    -- statistics, or NULL
+  -> Ptr CUInt     -- exitcode
+  -> IO (Ptr CTessellation)
+
+-- the same function imported as a safe call: the other Haskell threads keep
+-- running while qhull works, and several tessellations can run at the same
+-- time on different OS threads since each call has its own qhull context
+foreign import ccall safe "tessellation" c_tessellation_safe
+  :: Ptr CDouble   -- sites
+  -> CUInt         -- dim
+  -> CUInt         -- nsites
+  -> CUInt         -- 0/1, sites in rows of dim+1 coordinates, lifted in place
+  -> CUInt         -- 0/1, point at infinity
+  -> CUInt         -- 0/1, include degenerate
+  -> CDouble       -- volume threshold
+  -> CString       -- qhull options, or NULL for the default ones
+  -> CUInt         -- number of threads re-partitioning the sites
+  -> Ptr CProgress -- progress report and cancellation, or NULL
+  -> Ptr CStats    -- statistics, or NULL
+  -> Ptr CUInt     -- exitcode
   -> IO (Ptr CTessellation)
 
+foreign import ccall unsafe "freeTessellation" c_freeTessellation
+  :: Ptr CTessellation -- tessellation returned by tessellation
+  -> CUInt             -- nsites
+  -> IO ()
+
+foreign import ccall unsafe "estimatememory" c_estimatememory
+  :: CUInt -- nsites
+  -> CUInt -- dim
+  -> CSize
+
+-- safe: it waits for the lock of the pool
+foreign import ccall safe "qh_mempoolrelease" c_mempoolrelease
+  :: IO ()
+
 cTessellationToTessellation :: [[Double]] -> CTessellation -> IO Tessellation
-cTessellationToTessellation vertices ctess = do
+cTessellationToTessellation = cTessellationToTessellationWith return
+
+-- | conversion applying an action to each site, tile and tile facet as soon
+-- as it is marshaled (e.g. to move it into a compact region); the three
+-- arrays are converted by chunks, in parallel when the runtime has several
+-- capabilities
+cTessellationToTessellationWith :: (forall a. a -> IO a)
+                                -> [[Double]] -> CTessellation
+                                -> IO Tessellation
+cTessellationToTessellationWith store vertices ctess = do
   let ntiles    = fromIntegral $ __ntiles ctess
       nsubtiles = fromIntegral $ __nsubtiles ctess
-      nsites    = length vertices
-  sites''    <- peekArray nsites (__sites ctess)
-  tiles''    <- peekArray ntiles (__tiles ctess)
-  subtiles'' <- peekArray nsubtiles (__subtiles ctess)
-  sites'     <- mapM (cSiteToSite vertices) sites''
-  let sites = fromAscList (map (fst3 &&& snd3) sites')
-      edgesIndices = concatMap thd3 sites'
-      edges = map (toPair &&& both (_point . ((!) sites))) edgesIndices
-  tiles'     <- mapM (cTileToTile vertices) tiles''
-  subtiles'  <- mapM (cSubTiletoTileFacet vertices) subtiles''
+      nfamilies = fromIntegral $ __nfamilies ctess
+      nsites    = V.length points
+      points    = V.fromList vertices
+      dim       = length (V.head points)
+  families  <- V.fromList <$> (peekArray nfamilies (__families ctess) >>=
+                                 mapM (cFamilyToCircumsphere dim))
+  sites'    <- convertArray "convert sites" nsites (__sites ctess)
+                            (cSiteToSite points >=> traverse store)
+  tiles'    <- convertArray "convert tiles" ntiles (__tiles ctess)
+                            (cTileToTile points families >=> traverse store)
+  subtiles' <- convertArray "convert tile facets" nsubtiles (__subtiles ctess)
+                            (cSubTiletoTileFacet points >=> traverse store)
+  let sites = fromDistinctAscList sites'
+  -- the edges are left as a thunk: they are built from the sites only
+  -- when they are requested
   return Tessellation
          { _sites      = sites
-         , _tiles      = fromAscList tiles'
-         , _tilefacets = fromAscList subtiles'
-         , _edges'     = H.fromList edges }
+         , _tiles      = fromDistinctAscList tiles'
+         , _tilefacets = fromDistinctAscList subtiles'
+         , _edges'     = sitesToEdges sites }
+
+-- converts the n elements of a C array; the array is split in chunks which
+-- are peeked, converted and fully evaluated by concurrent threads, and the
+-- results are returned in the order of the array; each chunk is a span of
+-- the trace
+convertArray :: (Storable a, NFData b)
+             => String -> Int -> Ptr a -> (a -> IO b) -> IO [b]
+convertArray name n ptr convert = do
+  ncapabilities <- getNumCapabilities
+  if ncapabilities == 1 || n < 2 * minChunkSize
+    then convertChunk (0, n)
+    else do
+      let chunkSize = max minChunkSize (n `quot` (4 * ncapabilities) + 1)
+          chunks    = [(i, min chunkSize (n - i)) | i <- [0, chunkSize .. n-1]]
+      concat <$> forConcurrently chunks convertChunk
   where
-    toPair (i,j) = Pair i j
+    minChunkSize = 256
+    convertChunk (i, k) = traced name $ do
+      elems <- peekArray k (advancePtr ptr i)
+      mapM convert elems >>= evaluate . force
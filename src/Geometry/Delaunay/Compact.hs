@@ -0,0 +1,110 @@
+{-|
+Module      : Geometry.Delaunay.Compact
+Description : Compact regions of tessellations, and their serialization.
+
+A tessellation copied into a compact region is not traced by the garbage
+collector, which matters for long-lived tessellations of millions of tiles.
+A compact region can be written to a file and read back by the same
+executable, without rebuilding the tessellation. The header of the file is
+made of 64-bit words, whatever the platform.
+-}
+module Geometry.Delaunay.Compact
+  ( compactTessellation
+  , writeCompactTessellation
+  , readCompactTessellation
+  )
+  where
+import           Control.Monad               ( forM_ )
+import           Data.Word                   ( Word64 )
+import           Foreign.Marshal.Alloc       ( alloca )
+import           Foreign.Marshal.Utils       ( with )
+import           Foreign.Ptr                 ( Ptr, ptrToWordPtr, wordPtrToPtr )
+import           Foreign.Storable            ( peek, sizeOf )
+import           GHC.Compact                 ( Compact, compact )
+import           GHC.Compact.Serialized      ( SerializedCompact(..)
+                                             , importCompact
+                                             , withSerializedCompact
+                                             )
+import           Geometry.Delaunay.Types     ( Tessellation )
+import           System.IO                   ( Handle
+                                             , IOMode(ReadMode, WriteMode)
+                                             , hFileSize
+                                             , hGetBuf
+                                             , hPutBuf
+                                             , hTell
+                                             , withBinaryFile
+                                             )
+
+-- | copy a tessellation into a new compact region, which is not traced by
+-- the garbage collector; the tessellation is fully evaluated, including its
+-- edges
+compactTessellation :: Tessellation -> IO (Compact Tessellation)
+compactTessellation = compact
+
+-- | write a compact tessellation to a file; the file can be read only by the
+-- same executable, with 'readCompactTessellation'
+writeCompactTessellation :: FilePath -> Compact Tessellation -> IO ()
+writeCompactTessellation file tess =
+  withBinaryFile file WriteMode $ \h ->
+    withSerializedCompact tess $ \serialized -> do
+      let blocks = serializedCompactBlockList serialized
+      putWord64 h magicNumber
+      putWord64 h (fromIntegral $ length blocks)
+      forM_ blocks $ \(ptr, size) -> do
+        putWord64 h (ptrToWord64 ptr)
+        putWord64 h (fromIntegral size)
+      putWord64 h (ptrToWord64 (serializedCompactRoot serialized))
+      forM_ blocks $ \(ptr, size) -> hPutBuf h ptr (fromIntegral size)
+  where
+    ptrToWord64 = fromIntegral . ptrToWordPtr
+
+-- | read a compact tessellation written by 'writeCompactTessellation';
+-- returns @Nothing@ if the file is not a compact tessellation file, if it is
+-- truncated, or if the region cannot be imported at the addresses it was
+-- written from
+readCompactTessellation :: FilePath -> IO (Maybe (Compact Tessellation))
+readCompactTessellation file =
+  withBinaryFile file ReadMode $ \h -> do
+    magic <- getWord64 h
+    if magic /= Just magicNumber
+      then return Nothing
+      else do
+        header <- getWord64 h >>= maybe (return Nothing) (getHeader h)
+        case header of
+          Nothing -> return Nothing
+          Just (blocks, root) -> do
+            remaining <- (-) <$> hFileSize h <*> hTell h
+            if remaining < sum (map (toInteger . snd) blocks)
+              then return Nothing
+              else importCompact (SerializedCompact blocks root) $
+                     \ptr size -> () <$ hGetBuf h ptr (fromIntegral size)
+  where
+    getHeader h nblocks = do
+      blocks <- getBlocks h nblocks
+      root <- getWord64 h
+      return $ (,) <$> blocks <*> fmap word64ToPtr root
+    getBlocks _ 0 = return (Just [])
+    getBlocks h k = do
+      address <- getWord64 h
+      size    <- getWord64 h
+      case (,) <$> address <*> size of
+        Nothing -> return Nothing
+        Just (a, s) ->
+          fmap ((word64ToPtr a, fromIntegral s) :) <$> getBlocks h (k - 1)
+    word64ToPtr :: Word64 -> Ptr a
+    word64ToPtr = wordPtrToPtr . fromIntegral
+
+-- header of the files, "DELAUNAY" in ASCII
+magicNumber :: Word64
+magicNumber = 0x44454C41554E4159
+
+putWord64 :: Handle -> Word64 -> IO ()
+putWord64 h w = with w $ \ptr -> hPutBuf h ptr (sizeOf w)
+
+-- @Nothing@ at the end of the file
+getWord64 :: Handle -> IO (Maybe Word64)
+getWord64 h = alloca $ \ptr -> do
+  count <- hGetBuf h ptr (sizeOf (undefined :: Word64))
+  if count /= sizeOf (undefined :: Word64)
+    then return Nothing
+    else Just <$> peek ptr
@@ -1,5 +1,19 @@
 module Geometry.Delaunay.Delaunay
   ( delaunay
+  , delaunayWith
+  , defaultOptions
+  , qhullOptions
+  , delaunaySafe
+  , delaunayWithStats
+  , estimateMemory
+  , releaseMemoryPool
+  , delaunayCompact
+  , delaunayCloud
+  , DelaunayJob
+  , startDelaunay
+  , jobProgress
+  , cancelDelaunay
+  , waitDelaunay
   , vertexNeighborFacets
   , sandwichedFacet
   , facetOf
@@ -9,31 +23,65 @@ module Geometry.Delaunay.Delaunay
   , facetFamilies'
   , facetCenters'
   , getDelaunayTiles
+  , tessellationEdges
   ) 
   where
+import           Control.Concurrent.Async    ( Async, async, wait )
+import           Control.Exception           ( bracket, finally )
 import           Control.Monad               ( unless, when )
 import           Data.IntMap.Strict          ( IntMap )
 import qualified Data.IntMap.Strict          as IM
 import qualified Data.IntSet                 as IS
 import           Data.List.Unique            ( allUnique )
-import           Data.Maybe                  ( fromMaybe )
-import           Geometry.Delaunay.CDelaunay ( c_tessellation
+import           Data.Maybe                  ( fromJust, fromMaybe )
+import           GHC.Compact                 ( Compact
+                                             , compact
+                                             , compactAdd
+                                             , getCompact
+                                             )
+import           Geometry.Delaunay.CDelaunay ( CTessellation
+                                             , CProgress(..)
+                                             , CStats
+                                             , cStatsToStats
+                                             , cancelProgress
+                                             , cancelledExitCode
+                                             , c_tessellation
+                                             , c_tessellation_safe
+                                             , c_freeTessellation
+                                             , c_estimatememory
+                                             , c_mempoolrelease
                                              , cTessellationToTessellation 
+                                             , cTessellationToTessellationWith
+                                             , sitesToEdges
                                              )
+import           Geometry.Delaunay.Rbox      ( PointCloud(..), cloudPoints )
 import           Geometry.Delaunay.Types     ( Tessellation(_tilefacets, _sites, _tiles)
+                                             , Progress(..)
+                                             , Stats(_conversionTime)
+                                             , DelaunayOptions(..)
+                                             , Triangulation(..)
+                                             , Premerge(..)
                                              , Tile (..)
                                              , Simplex(_vertices')
                                              , TileFacet(_facetOf)
                                              , Site(_neighfacetsIds) 
                                              )
+import           Foreign.C.String            ( withCString )
 import           Foreign.C.Types             ( CDouble, CUInt )
-import           Foreign.Marshal.Alloc       ( free, mallocBytes )
-import           Foreign.Marshal.Array       ( pokeArray )
-import           Foreign.Storable            ( peek, sizeOf )
+import           Foreign.ForeignPtr          ( ForeignPtr
+                                             , mallocForeignPtr
+                                             , withForeignPtr
+                                             )
+import           Foreign.Marshal.Alloc       ( alloca, free, mallocBytes )
+import           Foreign.Marshal.Array       ( advancePtr, pokeArray )
+import           Foreign.Ptr                 ( Ptr, nullPtr )
+import           Foreign.Storable            ( peek, poke, sizeOf )
+import           GHC.Clock                   ( getMonotonicTime )
 import           Geometry.Qhull.Types        ( HasCenter(_center) 
                                              , HasFamily(_family)
                                              , Family
                                              , Index 
+                                             , EdgeMap
                                              )
 
 delaunay :: [[Double]]      -- ^ sites (vertex coordinates)
@@ -41,7 +89,225 @@ delaunay :: [[Double]]      -- ^ sites (vertex coordinates)
          -> Bool            -- ^ whether to include degenerate tiles
          -> Maybe Double    -- ^ volume threshold
          -> IO Tessellation -- ^ Delaunay tessellation
-delaunay sites atinfinity degenerate vthreshold = do
+delaunay sites atinfinity degenerate vthreshold =
+  delaunayWith (options atinfinity degenerate vthreshold) sites
+
+-- | default options: triangulated output (@Qt@), last coordinate scaled
+-- (@Qbb@), exact pre-merging in dimension > 3, no point at infinity, no
+-- degenerate tiles, no volume threshold, one thread
+defaultOptions :: DelaunayOptions
+defaultOptions = DelaunayOptions
+  { _atInfinity      = False
+  , _degenerate      = False
+  , _volumeThreshold = Nothing
+  , _triangulation   = Triangulate
+  , _scaleLast       = True
+  , _premerge        = DefaultPremerge
+  , _seed            = Nothing
+  , _centrumRadius   = Nothing
+  , _cosineAngle     = Nothing
+  , _threads         = 1 }
+
+-- options with the given arguments of 'delaunay'
+options :: Bool -> Bool -> Maybe Double -> DelaunayOptions
+options atinfinity degenerate vthreshold =
+  defaultOptions { _atInfinity      = atinfinity
+                 , _degenerate      = degenerate
+                 , _volumeThreshold = vthreshold }
+
+-- | qhull options corresponding to the given options, for the given
+-- dimension (they follow @qhull d@); with 'Exact', qhull does not pre-merge,
+-- so the pre-merging options are left out; the seed is not checked, this is
+-- done by 'delaunayWith'
+qhullOptions :: Int -> DelaunayOptions -> String
+qhullOptions dim opts = unwords $
+  [triangulation (_triangulation opts)] ++
+  ["Qbb" | _scaleLast opts] ++
+  ["Qz" | _atInfinity opts] ++
+  (if _triangulation opts == Exact then [] else premerge) ++
+  maybe [] (\s -> ["QR-" ++ show s]) (_seed opts)
+  where
+    triangulation Triangulate     = "Qt"
+    triangulation (Joggle jmax)   = "QJ" ++ maybe "" show jmax
+    triangulation Exact           = "QE"
+    premerge =
+      premergeOption (_premerge opts) ++
+      maybe [] (\c -> ["C-" ++ show c]) (_centrumRadius opts) ++
+      maybe [] (\a -> ["A-" ++ show a]) (_cosineAngle opts)
+    premergeOption DefaultPremerge = ["Qx" | dim > 3]
+    premergeOption ExactPremerge   = ["Qx"]
+    premergeOption NoPremerge      = ["Q0"]
+
+-- | Delaunay tessellation with the given options; the options
+-- 'defaultOptions' give the same tessellation as 'delaunay'; see the README
+-- for their impact on the speed
+delaunayWith :: DelaunayOptions  -- ^ options
+             -> [[Double]]       -- ^ sites (vertex coordinates)
+             -> IO Tessellation  -- ^ Delaunay tessellation
+delaunayWith opts sites = do
+  when (maybe False (< 2) (_seed opts)) $
+    error "the seed must be at least 2"
+  runDelaunay False (cTessellationToTessellation sites) sites opts
+
+-- | same as 'delaunay' but the C code is called with a safe foreign call:
+-- it does not block the other Haskell threads nor the garbage collector
+-- while it runs, at the price of a small overhead for the call; use it for
+-- long tessellations in a multithreaded program (compiled with @-threaded@),
+-- in which case several tessellations can run concurrently
+delaunaySafe :: [[Double]]      -- ^ sites (vertex coordinates)
+             -> Bool            -- ^ whether to add a point at infinity
+             -> Bool            -- ^ whether to include degenerate tiles
+             -> Maybe Double    -- ^ volume threshold
+             -> IO Tessellation -- ^ Delaunay tessellation
+delaunaySafe sites atinfinity degenerate vthreshold =
+  runDelaunay True (cTessellationToTessellation sites) sites
+              (options atinfinity degenerate vthreshold)
+
+-- | same as 'delaunay' and returns the statistics of the tessellation: time
+-- spent in each phase, qhull counters and memory used by qhull
+delaunayWithStats :: [[Double]]      -- ^ sites (vertex coordinates)
+                  -> Bool            -- ^ whether to add a point at infinity
+                  -> Bool            -- ^ whether to include degenerate tiles
+                  -> Maybe Double    -- ^ volume threshold
+                  -> IO (Tessellation, Stats)
+delaunayWithStats sites atinfinity degenerate vthreshold =
+  alloca $ \statsPtr -> do
+    (tess, tconversion) <- fromJust <$>
+      runDelaunayWithProgress False nullPtr statsPtr
+                              (timed . cTessellationToTessellation sites)
+                              sites (options atinfinity degenerate vthreshold)
+    cstats <- peek statsPtr
+    return (tess, (cStatsToStats cstats) { _conversionTime = tconversion })
+  where
+    timed action = do
+      t0 <- getMonotonicTime
+      x <- action
+      t1 <- getMonotonicTime
+      return (x, t1 - t0)
+
+-- | predicted peak memory in bytes of the C code (qhull, output of the C
+-- code and temporary arrays) for the given number of sites in general
+-- position and the given dimension; this allows to reject a tessellation
+-- which would not fit in memory before running it
+estimateMemory :: Int -- ^ number of sites
+               -> Int -- ^ dimension
+               -> Int
+estimateMemory n dim =
+  fromIntegral $ c_estimatememory (fromIntegral n) (fromIntegral dim)
+
+-- | free the idle chunks of the memory pool shared by the tessellations;
+-- after a large tessellation the pool keeps up to 16 chunks of 2 MB for the
+-- next ones, and this gives them back to the system; the chunks of a running
+-- tessellation are not freed
+releaseMemoryPool :: IO ()
+releaseMemoryPool = c_mempoolrelease
+
+-- | Delaunay tessellation built into a compact region: each site, tile and
+-- tile facet is moved to the region as soon as it is marshaled, so the
+-- tessellation is never copied as a whole and it is not traced by the
+-- garbage collector afterwards; note that the edges are computed
+delaunayCompact :: [[Double]]      -- ^ sites (vertex coordinates)
+                -> Bool            -- ^ whether to add a point at infinity
+                -> Bool            -- ^ whether to include degenerate tiles
+                -> Maybe Double    -- ^ volume threshold
+                -> IO (Compact Tessellation)
+delaunayCompact sites atinfinity degenerate vthreshold = do
+  region <- compact ()
+  tess <- runDelaunay False
+          (cTessellationToTessellationWith (toRegion region) sites)
+          sites (options atinfinity degenerate vthreshold)
+  compactAdd region tess
+  where
+    toRegion region x = getCompact <$> compactAdd region x
+
+-- | Delaunay tessellation of a point cloud generated by
+-- 'Geometry.Delaunay.Rbox.rbox'; the coordinate buffer is given as is to
+-- the C code, which lifts the sites in place; contrary to 'delaunay', the
+-- points are not checked for duplicates
+delaunayCloud :: PointCloud      -- ^ sites
+              -> Bool            -- ^ whether to add a point at infinity
+              -> Bool            -- ^ whether to include degenerate tiles
+              -> Maybe Double    -- ^ volume threshold
+              -> IO Tessellation -- ^ Delaunay tessellation
+delaunayCloud cloud atinfinity degenerate vthreshold = do
+  let n   = _cloudSize cloud
+      dim = _cloudDim cloud
+  when (dim < 2) $
+    error "dimension must be at least 2"
+  when (n <= dim+1) $
+    error "insufficient number of points"
+  sites <- cloudPoints cloud
+  fromJust <$> withForeignPtr (_cloudCoordinates cloud) (\sitesPtr ->
+    runTessellation False nullPtr nullPtr (cTessellationToTessellation sites)
+                    sitesPtr dim n True
+                    (options atinfinity degenerate vthreshold))
+
+-- | a tessellation running in a worker thread
+data DelaunayJob = DelaunayJob {
+    _progressPtr :: ForeignPtr CProgress
+  , _worker      :: Async (Maybe Tessellation)
+}
+
+-- | start a Delaunay tessellation in a worker thread, with a safe foreign
+-- call (see 'delaunaySafe'); its progress can be polled with 'jobProgress'
+-- and it can be cancelled with 'cancelDelaunay'; the program must be
+-- compiled with @-threaded@, otherwise the job blocks the other threads
+startDelaunay :: [[Double]]     -- ^ sites (vertex coordinates)
+              -> Bool           -- ^ whether to add a point at infinity
+              -> Bool           -- ^ whether to include degenerate tiles
+              -> Maybe Double   -- ^ volume threshold
+              -> IO DelaunayJob
+startDelaunay sites atinfinity degenerate vthreshold = do
+  progressPtr <- mallocForeignPtr
+  withForeignPtr progressPtr $ \ptr -> poke ptr (CProgress 0 0 0 0 0 0 0)
+  worker <- async $ withForeignPtr progressPtr $ \ptr ->
+    runDelaunayWithProgress True ptr nullPtr
+                            (cTessellationToTessellation sites)
+                            sites (options atinfinity degenerate vthreshold)
+  return DelaunayJob { _progressPtr = progressPtr, _worker = worker }
+
+-- | current progress of a tessellation job
+jobProgress :: DelaunayJob -> IO Progress
+jobProgress job = withForeignPtr (_progressPtr job) $ \ptr -> do
+  cprogress <- peek ptr
+  return Progress { _phase      = toEnum (fromIntegral $ __phase cprogress)
+                  , _npoints    = fromIntegral $ __npoints cprogress
+                  , _nprocessed = fromIntegral $ __nprocessed cprogress
+                  , _nfacets    = fromIntegral $ __nfacets cprogress
+                  , _ntiles     = fromIntegral $ __ntiles cprogress
+                  , _ndone      = fromIntegral $ __ndone cprogress }
+
+-- | request the cancellation of a tessellation job; it stops at the next
+-- point added by qhull or the next tile processed, and then 'waitDelaunay'
+-- returns @Nothing@
+cancelDelaunay :: DelaunayJob -> IO ()
+cancelDelaunay job = withForeignPtr (_progressPtr job) cancelProgress
+
+-- | wait for the end of a tessellation job; @Nothing@ if it has been
+-- cancelled
+waitDelaunay :: DelaunayJob -> IO (Maybe Tessellation)
+waitDelaunay = wait . _worker
+
+-- runs the C function without progress report, hence it cannot be cancelled
+runDelaunay :: Bool                    -- safe foreign call
+            -> (CTessellation -> IO a) -- conversion of the C output
+            -> [[Double]]              -- sites
+            -> DelaunayOptions         -- options
+            -> IO a
+runDelaunay safe convert sites opts =
+  fromJust <$> runDelaunayWithProgress safe nullPtr nullPtr convert sites opts
+
+-- runs the C function and converts its output with the given function;
+-- Nothing if the tessellation has been cancelled
+runDelaunayWithProgress
+  :: Bool                    -- safe foreign call
+  -> Ptr CProgress           -- progress report, or NULL
+  -> Ptr CStats              -- statistics, or NULL
+  -> (CTessellation -> IO a) -- conversion of the C output
+  -> [[Double]]              -- sites
+  -> DelaunayOptions         -- options
+  -> IO (Maybe a)
+runDelaunayWithProgress safe progressPtr statsPtr convert sites opts = do
   let n     = length sites
       dim   = length (head sites)
   when (dim < 2) $
@@ -52,27 +318,58 @@ delaunay sites atinfinity degenerate vthreshold = do
     error "the points must have the same dimension"
   unless (allUnique sites) $
     error "some points are duplicated"
-  let vthreshold' = fromMaybe 0 vthreshold 
-  sitesPtr <- mallocBytes (n * dim * sizeOf (undefined :: CDouble))
-  pokeArray sitesPtr (concatMap (map realToFrac) sites)
-  exitcodePtr <- mallocBytes (sizeOf (undefined :: CUInt))
-  resultPtr <- c_tessellation sitesPtr
-               (fromIntegral dim) (fromIntegral n)
-               (fromIntegral $ fromEnum atinfinity)
-               (fromIntegral $ fromEnum degenerate)
-               (realToFrac vthreshold') exitcodePtr
-  exitcode <- peek exitcodePtr
-  free exitcodePtr
-  free sitesPtr
-  if exitcode /= 0
-    then do
-      free resultPtr
-      error $ "qhull returned an error (code " ++ show exitcode ++ ")"
-    else do
-      result <- peek resultPtr
-      out <- cTessellationToTessellation sites result
-      free resultPtr
-      return out
+  -- the sites are written in rows with a spare coordinate, and a spare row
+  -- for the point at infinity; the C code lifts them to the paraboloid in
+  -- place and qhull works on this buffer, without a copy of its own
+  let stride = dim + 1
+      nrows  = if _atInfinity opts then n + 1 else n
+  -- the buffer is freed on every path, also when qhull fails
+  bracket (mallocBytes (nrows * stride * sizeOf (undefined :: CDouble)))
+          free $ \sitesPtr -> do
+    mapM_ (\(i, site) -> pokeArray (advancePtr sitesPtr (i * stride))
+                                   (map realToFrac site))
+          (zip [0 ..] sites)
+    runTessellation safe progressPtr statsPtr convert sitesPtr dim n True opts
+
+-- runs the C function on a coordinate buffer
+runTessellation
+  :: Bool                    -- safe foreign call
+  -> Ptr CProgress           -- progress report, or NULL
+  -> Ptr CStats              -- statistics, or NULL
+  -> (CTessellation -> IO a) -- conversion of the C output
+  -> Ptr CDouble             -- sites coordinates
+  -> Int                     -- dimension
+  -> Int                     -- number of sites
+  -> Bool                    -- sites in rows of dim+1, lifted by the C code
+  -> DelaunayOptions         -- options
+  -> IO (Maybe a)
+runTessellation safe progressPtr statsPtr convert sitesPtr dim n lifted
+                opts = do
+  let vthreshold' = fromMaybe 0 (_volumeThreshold opts)
+  let tessellationFun = if safe then c_tessellation_safe else c_tessellation
+  (resultPtr, exitcode) <- alloca $ \exitcodePtr -> do
+    resultPtr <- withCString (qhullOptions dim opts) $ \optionsPtr ->
+                 tessellationFun sitesPtr
+                 (fromIntegral dim) (fromIntegral n)
+                 (fromIntegral $ fromEnum lifted)
+                 (fromIntegral $ fromEnum (_atInfinity opts))
+                 (fromIntegral $ fromEnum (_degenerate opts))
+                 (realToFrac vthreshold') optionsPtr
+                 (fromIntegral $ max 1 (_threads opts)) progressPtr statsPtr
+                 exitcodePtr
+    exitcode <- peek exitcodePtr
+    return (resultPtr, exitcode :: CUInt)
+  if exitcode == cancelledExitCode
+    then return Nothing
+    else if exitcode /= 0
+      then do
+        free resultPtr
+        error $ "qhull returned an error (code " ++ show exitcode ++ ")"
+      else do
+        result <- peek resultPtr
+        out <- convert result
+                 `finally` c_freeTessellation resultPtr (fromIntegral n)
+        return (Just out)
 
 -- | tile facets a vertex belongs to, vertex given by its index;
 -- the output is the empty map if the index is not valid
@@ -118,3 +415,9 @@ facetCenters' = funofFacetToFunofInt facetCenters
 -- | list of the maps of vertices for all tiles
 getDelaunayTiles :: Tessellation -> [IntMap [Double]]
 getDelaunayTiles tess = IM.elems $ IM.map (_vertices' . _simplex) (_tiles tess)
+
+-- | the edges of the tessellation, derived from the neighbor sites; this is
+-- the same map as the one held by the '_edges'' field, which is computed
+-- the first time it is accessed
+tessellationEdges :: Tessellation -> EdgeMap
+tessellationEdges = sitesToEdges . _sites
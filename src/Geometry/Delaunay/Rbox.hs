@@ -0,0 +1,70 @@
+{-# LANGUAGE ForeignFunctionInterface #-}
+module Geometry.Delaunay.Rbox
+  ( PointCloud(..)
+  , rbox
+  , cloudPoints
+  )
+  where
+import           Foreign.C.String            ( CString, withCString )
+import           Foreign.C.Types             ( CDouble(..), CUInt(..) )
+import           Foreign.ForeignPtr          ( ForeignPtr
+                                             , newForeignPtr
+                                             , withForeignPtr
+                                             )
+import           Foreign.Marshal.Alloc       ( alloca, finalizerFree )
+import           Foreign.Marshal.Array       ( peekArray )
+import           Foreign.Ptr                 ( Ptr )
+import           Foreign.Storable            ( peek )
+
+-- | points generated by 'rbox', kept in the coordinate buffer written by
+-- the C code; this buffer is given as is to the tessellation by
+-- 'Geometry.Delaunay.delaunayCloud'
+data PointCloud = PointCloud {
+    _cloudDim         :: Int
+  , _cloudSize        :: Int
+  , _cloudCoordinates :: ForeignPtr CDouble
+    -- ^ rows of dim+1 coordinates and a spare row; the last column and the
+    -- spare row are written by the tessellation, which lifts the sites in
+    -- place
+}
+
+foreign import ccall unsafe "rboxpoints" c_rboxpoints
+  :: CString   -- rbox command
+  -> Ptr CUInt -- dim
+  -> Ptr CUInt -- number of points
+  -> Ptr CUInt -- exitcode
+  -> IO (Ptr CDouble)
+
+-- | generate points with qhull's @rbox@, e.g. @rbox "rbox 1000 s D3"@ for
+-- 1000 points on the unit sphere; see the rbox documentation for the
+-- options; the default seed is fixed, use the option @t@ for a random one;
+-- note that the option @h@ (cdd format) adds a first coordinate equal to 1
+rbox :: String        -- ^ rbox command
+     -> IO PointCloud
+rbox command =
+  withCString command $ \commandPtr ->
+  alloca $ \dimPtr ->
+  alloca $ \nPtr ->
+  alloca $ \exitcodePtr -> do
+    pointsPtr <- c_rboxpoints commandPtr dimPtr nPtr exitcodePtr
+    exitcode <- peek exitcodePtr
+    if exitcode /= 0
+      then error $ "rbox returned an error (code " ++ show exitcode ++ ")"
+      else do
+        dim <- peek dimPtr
+        n <- peek nPtr
+        coordinates <- newForeignPtr finalizerFree pointsPtr
+        return PointCloud { _cloudDim         = fromIntegral dim
+                          , _cloudSize        = fromIntegral n
+                          , _cloudCoordinates = coordinates }
+
+-- | the points of a point cloud
+cloudPoints :: PointCloud -> IO [[Double]]
+cloudPoints cloud =
+  withForeignPtr (_cloudCoordinates cloud) $ \ptr -> do
+    coordinates <- peekArray ((dim+1) * _cloudSize cloud) ptr
+    return $ rows (map realToFrac coordinates)
+  where
+    dim = _cloudDim cloud
+    rows [] = []
+    rows xs = let (row, rest) = splitAt (dim+1) xs in take dim row : rows rest
@@ -0,0 +1,149 @@
+{-|
+Module      : Geometry.Delaunay.Strict
+Description : Strict representation of a Delaunay tessellation.
+Copyright   : (c) Stéphane Laurent, 2023
+License     : GPL-3
+Maintainer  : laurent_step@outlook.fr
+
+Strict counterparts of the types of "Geometry.Delaunay". The fields are
+strict, the numbers are unpacked and the coordinates are stored in unboxed
+vectors, so that a tessellation held in memory does not contain any thunk
+and is cheap to traverse for the garbage collector. The vertices of a simplex
+are given by their identifiers only; their coordinates are the points of the
+sites.
+
+The names clash with the ones of "Geometry.Delaunay", hence this module is
+intended to be imported qualified.
+-}
+module Geometry.Delaunay.Strict
+  (
+    Site (..)
+  , Simplex (..)
+  , TileFacet (..)
+  , Tile (..)
+  , Tessellation (..)
+  , toStrict
+  , delaunay
+  )
+  where
+import           Control.DeepSeq            ( NFData(rnf) )
+import           Data.IntMap.Strict         ( IntMap )
+import qualified Data.IntMap.Strict         as IM
+import           Data.IntSet                ( IntSet )
+import qualified Data.Vector.Unboxed        as U
+import qualified Geometry.Delaunay.Delaunay as L
+import qualified Geometry.Delaunay.Types    as L
+import           Geometry.Qhull.Types       ( HasFamily(..),
+                                              HasVolume(..),
+                                              Family(..),
+                                              Index,
+                                              IndexSet,
+                                              IndexMap )
+
+data Site = Site {
+    _point          :: !(U.Vector Double)
+  , _neighsitesIds  :: !IndexSet
+  , _neighfacetsIds :: !IntSet
+  , _neightilesIds  :: !IntSet
+} deriving Show
+
+instance NFData Site where
+  rnf (Site p s f t) = rnf p `seq` rnf s `seq` rnf f `seq` rnf t
+
+data Simplex = Simplex {
+    _verticesIds  :: !(U.Vector Index)
+  , _circumcenter :: !(U.Vector Double)
+  , _circumradius :: {-# UNPACK #-} !Double
+  , _volume'      :: {-# UNPACK #-} !Double
+} deriving Show
+
+instance NFData Simplex where
+  rnf (Simplex v c _ _) = rnf v `seq` rnf c
+
+instance HasVolume Simplex where
+  _volume = _volume'
+
+data TileFacet = TileFacet {
+    _subsimplex :: {-# UNPACK #-} !Simplex
+  , _facetOf    :: !IntSet
+  , _normal'    :: !(U.Vector Double)
+  , _offset'    :: {-# UNPACK #-} !Double
+} deriving Show
+
+instance NFData TileFacet where
+  rnf (TileFacet s f n _) = rnf s `seq` rnf f `seq` rnf n
+
+instance HasVolume TileFacet where
+  _volume = _volume' . _subsimplex
+
+data Tile = Tile {
+    _simplex      :: {-# UNPACK #-} !Simplex
+  , _neighborsIds :: !IntSet
+  , _facetsIds    :: !IntSet
+  , _family'      :: !Family
+  , _toporiented  :: !Bool
+} deriving Show
+
+instance NFData Tile where
+  rnf (Tile s n f fam _) = rnf s `seq` rnf n `seq` rnf f `seq` rnf fam
+
+instance HasFamily Tile where
+  _family = _family'
+
+instance HasVolume Tile where
+  _volume = _volume' . _simplex
+
+data Tessellation = Tessellation {
+    _sites      :: !(IndexMap Site)
+  , _tiles      :: !(IntMap Tile)
+  , _tilefacets :: !(IntMap TileFacet)
+} deriving Show
+
+instance NFData Tessellation where
+  rnf (Tessellation s t f) = rnf s `seq` rnf t `seq` rnf f
+
+instance HasVolume Tessellation where
+  _volume tess = sum (IM.elems $ IM.map (_volume' . _simplex) (_tiles tess))
+
+-- | strict copy of a tessellation; the result is fully evaluated as soon as
+-- it is in weak head normal form, and it does not retain its argument
+toStrict :: L.Tessellation -> Tessellation
+toStrict tess = Tessellation
+  { _sites      = IM.map site (L._sites tess)
+  , _tiles      = IM.map tile (L._tiles tess)
+  , _tilefacets = IM.map tilefacet (L._tilefacets tess) }
+  where
+    simplex s = Simplex
+      { _verticesIds  = U.fromList (IM.keys (L._vertices' s))
+      , _circumcenter = U.fromList (L._circumcenter s)
+      , _circumradius = L._circumradius s
+      , _volume'      = L._volume' s }
+    site s = Site
+      { _point          = U.fromList (L._point s)
+      , _neighsitesIds  = L._neighsitesIds s
+      , _neighfacetsIds = L._neighfacetsIds s
+      , _neightilesIds  = L._neightilesIds s }
+    tile t = Tile
+      { _simplex      = simplex (L._simplex t)
+      , _neighborsIds = L._neighborsIds t
+      , _facetsIds    = L._facetsIds t
+      , _family'      = family (L._family' t)
+      , _toporiented  = L._toporiented t }
+    tilefacet f = TileFacet
+      { _subsimplex = simplex (L._subsimplex f)
+      , _facetOf    = L._facetOf f
+      , _normal'    = U.fromList (L._normal' f)
+      , _offset'    = L._offset' f }
+    family fam@(Family i) = i `seq` fam
+    family None           = None
+
+-- | Delaunay tessellation with a strict result; see
+-- 'Geometry.Delaunay.delaunay' for the arguments
+delaunay :: [[Double]]      -- ^ sites (vertex coordinates)
+         -> Bool            -- ^ whether to add a point at infinity
+         -> Bool            -- ^ whether to include degenerate tiles
+         -> Maybe Double    -- ^ volume threshold
+         -> IO Tessellation -- ^ Delaunay tessellation
+delaunay sites atinfinity degenerate vthreshold = do
+  tess <- L.delaunay sites atinfinity degenerate vthreshold
+  return $! toStrict tess
@@ -0,0 +1,74 @@
+{-# LANGUAGE CPP #-}
+{-# LANGUAGE ForeignFunctionInterface #-}
+{-|
+Module      : Geometry.Delaunay.Trace
+Description : Event tracing of the tessellations.
+
+The trace points of the C code (phases of the tessellation, construction
+and triangulation of the hull by qhull) and of the conversion of its output
+are compiled only with the flag @trace@ of the package; otherwise they cost
+nothing and 'writeTrace' writes an empty trace. The last 65536 events are
+kept in a ring buffer, and they are written as Chrome trace JSON, which can
+be opened with @chrome://tracing@ or <https://ui.perfetto.dev>.
+-}
+module Geometry.Delaunay.Trace
+  ( traceEnabled
+  , traced
+  , writeTrace
+  , clearTrace
+  )
+  where
+#ifdef DELAUNAY_TRACE
+import           Control.Exception          ( bracket_ )
+import           Foreign.C.String           ( castCharToCChar )
+#endif
+import           Control.Monad              ( when )
+import           Foreign.C.String           ( CString, withCString )
+import           Foreign.C.Types            ( CChar(..), CUInt(..) )
+import           System.IO.Error            ( ioeSetFileName )
+
+foreign import ccall unsafe "traceenabled" c_traceenabled
+  :: CUInt
+
+foreign import ccall unsafe "traceevent" c_traceevent
+  :: CString -- name
+  -> CChar   -- 'B' begin, 'E' end
+  -> IO ()
+
+foreign import ccall unsafe "traceclear" c_traceclear
+  :: IO ()
+
+foreign import ccall unsafe "tracewrite" c_tracewrite
+  :: CString -- file name
+  -> IO CUInt
+
+-- | whether the package has been compiled with the trace points
+traceEnabled :: Bool
+traceEnabled = c_traceenabled /= 0
+
+-- | run an action as a span of the trace (names longer than 31 characters
+-- are truncated); this is the identity without the flag @trace@
+traced :: String -> IO a -> IO a
+#ifdef DELAUNAY_TRACE
+traced name action =
+  withCString name $ \cname ->
+    bracket_ (c_traceevent cname begin) (c_traceevent cname end) action
+  where
+    begin = castCharToCChar 'B'
+    end   = castCharToCChar 'E'
+#else
+traced _ action = action
+#endif
+
+-- | write the recorded events to a file, as Chrome trace JSON; this must
+-- not be called while a tessellation is running; throws an 'IOError' if the
+-- file cannot be written
+writeTrace :: FilePath -> IO ()
+writeTrace file = do
+  ok <- withCString file c_tracewrite
+  when (ok == 0) $
+    ioError $ ioeSetFileName (userError "cannot write the trace") file
+
+-- | forget the recorded events
+clearTrace :: IO ()
+clearTrace = c_traceclear
@@ -5,8 +5,15 @@ module Geometry.Delaunay.Types
   , TileFacet (..)
   , Tile (..)
   , Tessellation (..)
+  , Phase (..)
+  , Progress (..)
+  , Stats (..)
+  , Triangulation (..)
+  , Premerge (..)
+  , DelaunayOptions (..)
   )
   where
+import           Control.DeepSeq      ( NFData(rnf) )
 import           Data.IntMap.Strict   ( IntMap )
 import qualified Data.IntMap.Strict    as IM
 import           Data.IntSet          ( IntSet )
@@ -28,6 +35,9 @@ data Site = Site {
   , _neightilesIds  :: IntSet
 } deriving Show
 
+instance NFData Site where
+  rnf (Site p s f t) = rnf p `seq` rnf s `seq` rnf f `seq` rnf t
+
 data Simplex = Simplex {
     _vertices'    :: IndexMap [Double]
   , _circumcenter :: [Double]
@@ -35,6 +45,9 @@ data Simplex = Simplex {
   , _volume'      :: Double
 } deriving Show
 
+instance NFData Simplex where
+  rnf (Simplex v c r vol) = rnf v `seq` rnf c `seq` rnf r `seq` rnf vol
+
 instance HasCenter Simplex where
   _center = _circumcenter
 
@@ -51,6 +64,9 @@ data TileFacet = TileFacet {
   , _offset'    :: Double
 } deriving Show
 
+instance NFData TileFacet where
+  rnf (TileFacet s f n o) = rnf s `seq` rnf f `seq` rnf n `seq` rnf o
+
 instance HasNormal TileFacet where
   _normal = _normal'
   _offset = _offset'
@@ -72,6 +88,10 @@ data Tile = Tile {
   , _toporiented  :: Bool
 } deriving Show
 
+instance NFData Tile where
+  rnf (Tile s n f fam o) =
+    rnf s `seq` rnf n `seq` rnf f `seq` rnf fam `seq` rnf o
+
 instance HasFamily Tile where
   _family = _family'
 
@@ -88,9 +108,12 @@ data Tessellation = Tessellation {
     _sites      :: IndexMap Site
   , _tiles      :: IntMap Tile
   , _tilefacets :: IntMap TileFacet
-  , _edges'     :: EdgeMap
+  , _edges'     :: EdgeMap -- ^ lazy, built from the sites on first access
 } deriving Show
 
+instance NFData Tessellation where
+  rnf (Tessellation s t f e) = rnf s `seq` rnf t `seq` rnf f `seq` rnf e
+
 instance HasEdges Tessellation where
   _edges = _edges'
 
@@ -99,3 +122,89 @@ instance HasVertices Tessellation where
 
 instance HasVolume Tessellation where
   _volume tess = sum (IM.elems $ IM.map (_volume' . _simplex) (_tiles tess))
+
+-- | phase of a tessellation job
+data Phase = Start  -- ^ not started yet
+           | Build  -- ^ construction of the hull by qhull
+           | Tiles  -- ^ volumes, centers, neighbors of the tiles
+           | Sites  -- ^ neighbors of the sites
+           | Ridges -- ^ tile facets
+           | Done
+     deriving (Show, Read, Eq, Ord, Enum, Bounded)
+
+-- | progress of a tessellation job
+data Progress = Progress {
+    _phase      :: Phase
+  , _npoints    :: Int -- ^ number of points given to qhull
+  , _nprocessed :: Int -- ^ number of points processed by qhull
+  , _nfacets    :: Int -- ^ number of facets created by qhull
+  , _ntiles     :: Int -- ^ number of tiles, once the hull is built
+  , _ndone      :: Int -- ^ number of tiles done in the current phase
+} deriving Show
+
+-- | statistics of a tessellation; the times are wall times in seconds, the
+-- counters are the ones of qhull, and the memory sizes are in bytes; the
+-- memory of the Haskell output is not included
+data Stats = Stats {
+    _buildTime         :: Double -- ^ construction of the hull, with merging
+  , _triangulationTime :: Double -- ^ triangulation of the hull (option Qt)
+  , _tilesTime         :: Double -- ^ volumes, centers, neighbors of the tiles
+  , _sitesTime         :: Double -- ^ neighbors of the sites
+  , _ridgesTime        :: Double -- ^ tile facets
+  , _cTime             :: Double -- ^ whole C function
+  , _conversionTime    :: Double -- ^ conversion of the C output to Haskell
+  , _npartitions       :: Int    -- ^ distance tests for partitioning the points
+  , _nvisible          :: Int    -- ^ visible facets deleted
+  , _nmerges           :: Int    -- ^ merged facets
+  , _nretries          :: Int    -- ^ retries due to precision problems,
+                                 -- e.g. new joggles with @QJ@
+  , _nhullFacets       :: Int    -- ^ facets of the hull
+  , _nhullVertices     :: Int    -- ^ vertices of the hull
+  , _ntessTiles        :: Int    -- ^ tiles of the tessellation
+  , _ntessRidges       :: Int    -- ^ tile facets of the tessellation
+  , _shortMemory       :: Int    -- ^ short memory of qhull in use at the end
+  , _longMemory        :: Int    -- ^ long memory of qhull in use at the end
+  , _maxLongMemory     :: Int    -- ^ peak of the long memory of qhull
+  , _bufferMemory      :: Int    -- ^ short memory buffers of qhull
+  , _allocations       :: Int    -- ^ allocations of the C output
+  , _totalAllocations  :: Int    -- ^ allocations of the C code
+  , _outputMemory      :: Int    -- ^ memory of the C output
+  , _peakOutputMemory  :: Int    -- ^ peak of the C output and temporaries
+  , _peakMemory        :: Int    -- ^ peak of qhull and the C code together
+  , _joggle            :: Double -- ^ joggle of the input with @QJ@, else 0
+} deriving Show
+
+-- | how qhull makes a simplicial output
+data Triangulation
+  = Triangulate
+    -- ^ option @Qt@: the non-simplicial facets are triangulated, giving
+    -- tiles of the same family (tricoplanar) and possibly degenerate tiles
+  | Joggle (Maybe Double)
+    -- ^ option @QJ@: the input is joggled, with the given maximal joggle
+    -- relative to the size of the input (qhull's default if @Nothing@)
+  | Exact
+    -- ^ option @QE@: exact predicates, with a symbolic perturbation of the
+    -- degenerate inputs; the tiles are simplicial and not degenerate, they
+    -- have no family, and qhull does not pre-merge (dimension at most 8)
+  deriving (Show, Eq)
+
+-- | pre-merging of the facets by qhull
+data Premerge = DefaultPremerge -- ^ exact pre-merging in dimension > 3
+              | ExactPremerge   -- ^ option @Qx@: exact pre-merging
+              | NoPremerge      -- ^ option @Q0@: no pre-merging
+  deriving (Show, Eq)
+
+-- | options of a tessellation; see 'Geometry.Delaunay.defaultOptions'
+data DelaunayOptions = DelaunayOptions {
+    _atInfinity      :: Bool          -- ^ add a point at infinity (@Qz@)
+  , _degenerate      :: Bool          -- ^ include the degenerate tiles
+  , _volumeThreshold :: Maybe Double  -- ^ volume threshold
+  , _triangulation   :: Triangulation -- ^ @Qt@, @QJ@ or @QE@
+  , _scaleLast       :: Bool          -- ^ scale the last coordinate (@Qbb@)
+  , _premerge        :: Premerge      -- ^ @Qx@ or @Q0@
+  , _seed            :: Maybe Int     -- ^ random seed, at least 2 (@QR-n@)
+  , _centrumRadius   :: Maybe Double  -- ^ pre-merge centrum radius (@C-n@)
+  , _cosineAngle     :: Maybe Double  -- ^ pre-merge angle cosine (@A-n@)
+  , _threads         :: Int           -- ^ number of threads re-partitioning
+                                      -- the sites after merges
+} deriving Show
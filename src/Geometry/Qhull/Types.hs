@@ -14,6 +14,7 @@ module Geometry.Qhull.Types
   , HasVolume (..)
   )
   where
+import           Control.DeepSeq            ( NFData(rnf) )
 import           Data.Hashable              ( Hashable(hashWithSalt) )
 import           Data.HashMap.Strict.InsOrd ( InsOrdHashMap )
 import           Data.IntMap.Strict         ( IntMap )
@@ -28,6 +29,9 @@ data IndexPair = Pair Index Index
 instance Eq IndexPair where
     Pair i j == Pair i' j' = (i == i' && j == j') || (i == j' && j == i')
 
+instance NFData IndexPair where
+  rnf (Pair i j) = rnf i `seq` rnf j
+
 instance Hashable IndexPair where
   hashWithSalt _ (Pair i j) = (i+j)*(i+j+1) + 2 * min i j
 
@@ -36,6 +40,10 @@ type EdgeMap = InsOrdHashMap IndexPair ([Double],[Double])
 data Family = Family Int | None
      deriving (Show, Read, Eq)
 
+instance NFData Family where
+  rnf (Family i) = rnf i
+  rnf None       = ()
+
 class HasFamily m where
   _family :: m -> Family
 